@@ -0,0 +1,163 @@
+#include "primeDetector.h"
+#include "primeKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Custom data struct that stores a named list of numbers to benchmark
+struct Dataset {
+    string name;
+    vector<int64_t> numbers;
+};
+
+/**
+ * Function that reads all the numbers from a file the same way main.cpp reads them from stdin
+ * @param path - Path of the file to read
+ * @param dataset - Reference to the dataset that the numbers are appended to
+ * @return bool - Boolean of whether or not the file could be opened
+ */
+static bool loadFile(const string &path, Dataset &dataset) {
+    ifstream input(path);
+    if (!input)
+        return false;
+    int64_t num;
+    while (input >> num)
+        dataset.numbers.push_back(num);
+    return true;
+}
+
+/**
+ * Function that returns a random prime in [low, high) (high - low must be large enough to contain one)
+ */
+static int64_t randomPrime(mt19937_64 &generator, int64_t low, int64_t high) {
+    uniform_int_distribution<int64_t> distribution(low, high - 1);
+    while (true) {
+        int64_t candidate = distribution(generator) | 1;
+        if (millerRabin(uint64_t(candidate)))
+            return candidate;
+    }
+}
+
+/**
+ * Function that builds the synthetic datasets (fixed seed so that runs can be compared)
+ * @param size - Number of numbers in the large datasets
+ * @return vector - Vector of the synthetic datasets
+ */
+static vector<Dataset> syntheticDatasets(size_t size) {
+    mt19937_64 generator(457);
+    vector<Dataset> datasets;
+
+    // Many uniformly distributed numbers below 2^32 (exercises the batched trial division kernel)
+    Dataset small{"many-small", {}};
+    uniform_int_distribution<int64_t> smallDistribution(0, UINT32_MAX);
+    for (size_t i = 0; i < size; i++)
+        small.numbers.push_back(smallDistribution(generator));
+    datasets.push_back(small);
+
+    // A few primes close to 2^63 (every Miller-Rabin base has to be tried)
+    Dataset huge{"few-huge-primes", {}};
+    for (int i = 0; i < 64; i++)
+        huge.numbers.push_back(randomPrime(generator, INT64_MAX - (int64_t(1) << 40), INT64_MAX));
+    datasets.push_back(huge);
+
+    // Products of two primes of similar size (no small factor for trial division to find)
+    Dataset semiprimes{"semiprimes", {}};
+    for (size_t i = 0; i < size / 16; i++) {
+        bool large = i % 2;
+        int64_t p = randomPrime(generator, large ? 1 << 30 : 1 << 15, large ? INT32_MAX : 1 << 16);
+        int64_t q = randomPrime(generator, large ? 1 << 30 : 1 << 15, large ? INT32_MAX : 1 << 16);
+        semiprimes.numbers.push_back(p * q);
+    }
+    datasets.push_back(semiprimes);
+
+    // Few distinct values repeated many times (exercises the deduplication)
+    Dataset duplicates{"duplicates", {}};
+    vector<int64_t> distinct;
+    for (int i = 0; i < 16; i++)
+        distinct.push_back(randomPrime(generator, int64_t(1) << 40, int64_t(1) << 62));
+    for (size_t i = 0; i < size; i++)
+        duplicates.numbers.push_back(distinct[generator() % distinct.size()]);
+    datasets.push_back(duplicates);
+    return datasets;
+}
+
+static void usage(const char *pname) {
+    cout << "Usage: " << pname << " [maxThreads] [syntheticSize] [file ...]\n"
+         << "    maxThreads defaults to 8, syntheticSize to 1000000, and the files to\n"
+         << "    easy.txt medium.txt hard.txt hard2.txt\n";
+    exit(-1);
+}
+
+int main(int argc, char **argv) {
+    int maxThreads = 8;
+    long syntheticSize = 1000000;
+    if (argc >= 2) maxThreads = atoi(argv[1]);
+    if (argc >= 3) syntheticSize = atol(argv[2]);
+    if (maxThreads < 1 || maxThreads > 256 || syntheticSize < 16) usage(argv[0]);
+    vector<string> files{"easy.txt", "medium.txt", "hard.txt", "hard2.txt"};
+    if (argc >= 4) files.assign(argv + 3, argv + argc);
+
+    vector<Dataset> datasets;
+    for (auto &file : files) {
+        Dataset dataset{file, {}};
+        if (loadFile(file, dataset))
+            datasets.push_back(dataset);
+        else
+            cerr << "Skipping " << file << " (could not open it)\n";
+    }
+    for (auto &dataset : syntheticDatasets(size_t(syntheticSize)))
+        datasets.push_back(dataset);
+
+    // Thread counts to try: powers of two up to maxThreads, plus maxThreads itself
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    // Builds the divisor table used by the kernels so that the first measurement does not pay for it
+    PrimeDetector(1).detect(vector<int64_t>{25});
+
+    cout << "dataset,threads,numbers,primes,seconds,numbers_per_second,speedup,efficiency,"
+            "mean_busy_seconds,mean_wait_seconds,load_imbalance,per_thread_busy_seconds\n";
+    cout << fixed << setprecision(6);
+    for (auto &dataset : datasets) {
+        double baseline = 0;
+        for (int threads : threadCounts) {
+            // Creates the pool up front so that thread creation is not part of the measurement
+            PrimeDetector detector(threads);
+            detector.resetStats();
+            auto start = chrono::steady_clock::now();
+            size_t primes = detector.detect(dataset.numbers).size();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (threads == 1)
+                baseline = seconds;
+
+            // Time a thread was not busy while the batch ran is time it spent waiting for the other threads
+            vector<PrimeDetector::ThreadStats> stats = detector.stats();
+            double totalBusy = 0;
+            double maxBusy = 0;
+            string perThread;
+            for (auto &threadStats : stats) {
+                totalBusy += threadStats.busySeconds;
+                maxBusy = max(maxBusy, threadStats.busySeconds);
+                perThread += (perThread.empty() ? "" : ";") + to_string(threadStats.busySeconds);
+            }
+            double meanBusy = totalBusy / threads;
+            double speedup = seconds > 0 ? baseline / seconds : 0;
+            cout << dataset.name << "," << threads << "," << dataset.numbers.size() << "," << primes << ","
+                 << seconds << "," << (seconds > 0 ? dataset.numbers.size() / seconds : 0) << ","
+                 << speedup << "," << speedup / threads << "," << meanBusy << ","
+                 << max(0.0, seconds - meanBusy) << "," << (meanBusy > 0 ? maxBusy / meanBusy : 1) << ","
+                 << perThread << "\n";
+        }
+    }
+    return 0;
+}
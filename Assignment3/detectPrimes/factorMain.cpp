@@ -0,0 +1,49 @@
+#include "factorNumbers.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Entry point of the factoring mode, kept apart from main.cpp so the assignment driver stays untouched
+ * @note Usage: detectPrimesFactor [nThreads], the numbers are read from stdin and the prime factorization of every number is printed
+ */
+int main(int argc, char **argv) {
+    int nThreads = 1;
+    if (argc != 1 && argc != 2) {
+        cout << "Usage: " << argv[0] << " [nThreads]\n"
+             << "    the default for nThreads is 1 thread.\n"
+             << "    prints the prime factorization of every number.\n";
+        exit(-1);
+    }
+    if (argc == 2)
+        nThreads = atoi(argv[1]);
+    if (nThreads < 1 || nThreads > 256) {
+        cout << "Bad arguments. 1 <= nThreads <= 256!\n";
+        exit(-1);
+    }
+    cout << "Using " << nThreads << " thread" << (nThreads == 1 ? "" : "s") << ".\n";
+
+    // Reads every number the same way main.cpp does
+    vector<int64_t> nums;
+    int64_t num;
+    while (cin >> num)
+        nums.push_back(num);
+
+    auto start = chrono::steady_clock::now();
+    vector<vector<int64_t>> factorizations = factor_numbers(nums, nThreads);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Factored " << nums.size() << " numbers:\n";
+    for (size_t i = 0; i < nums.size(); i++) {
+        cout << "  " << nums[i] << " =";
+        for (size_t j = 0; j < factorizations[i].size(); j++)
+            cout << (j ? " * " : " ") << factorizations[i][j];
+        cout << "\n";
+    }
+    cout << "\nFinished in " << fixed << setprecision(4) << elapsed << "s\n";
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include "factorNumbers.h"
+#include "primeKernels.h"
+#include <pthread.h>
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+
+using namespace std;
+
+// Primes that are divided out by trial division before Pollard-rho is used (rho is slow to find tiny factors)
+static const uint64_t smallPrimes[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73,
+                                       79, 83, 89, 97};
+
+// Number of steps of the rho iteration whose differences are multiplied together before a single gcd is taken
+static constexpr uint64_t gcdBatchSize = 128;
+
+// Custom data struct that performs arithmetic modulo an odd n in Montgomery form (a is stored as a * 2^64 mod n)
+struct Montgomery {
+    uint64_t n;
+    // -n^-1 mod 2^64
+    uint64_t negInverse;
+    // 2^128 mod n (used to convert numbers into Montgomery form)
+    uint64_t rSquared;
+
+    explicit Montgomery(uint64_t modulus) : n(modulus) {
+        // Newton's iteration doubles the number of correct low bits every step (n is its own inverse mod 8)
+        uint64_t inverse = n;
+        for (int i = 0; i < 5; i++)
+            inverse *= 2 - n * inverse;
+        negInverse = 0 - inverse;
+        uint64_t r = (0 - n) % n;
+        rSquared = uint64_t((unsigned __int128) r * r % n);
+    }
+
+    // Computes t * 2^-64 mod n (t must be below n * 2^64)
+    uint64_t reduce(unsigned __int128 t) const {
+        uint64_t m = uint64_t(t) * negInverse;
+        uint64_t result = uint64_t((t + (unsigned __int128) m * n) >> 64);
+        return result >= n ? result - n : result;
+    }
+
+    uint64_t toMontgomery(uint64_t a) const { return reduce((unsigned __int128) (a % n) * rSquared); }
+
+    uint64_t multiply(uint64_t a, uint64_t b) const { return reduce((unsigned __int128) a * b); }
+
+    uint64_t add(uint64_t a, uint64_t b) const { return a >= n - b ? a - (n - b) : a + b; }
+};
+
+/**
+ * Function that computes the greatest common divisor of two numbers (binary algorithm)
+ */
+static uint64_t gcd(uint64_t a, uint64_t b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    int shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+    while (b) {
+        b >>= __builtin_ctzll(b);
+        if (a > b) swap(a, b);
+        b -= a;
+    }
+    return a << shift;
+}
+
+/**
+ * Function that searches for a non trivial divisor of n with Pollard-rho using Brent's cycle detection
+ * @param n - Odd composite number to find a divisor of
+ * @param c - Constant of the iterated polynomial x^2 + c (different values give different sequences)
+ * @return uint64_t - Divisor of n (equals n when the sequence failed, the caller should retry with another c)
+ */
+static uint64_t pollardBrent(uint64_t n, uint64_t c) {
+    Montgomery mont(n);
+    const uint64_t constant = mont.toMontgomery(c);
+    auto step = [&](uint64_t x) { return mont.add(mont.multiply(x, x), constant); };
+
+    uint64_t y = mont.toMontgomery(2);
+    uint64_t x = y;
+    uint64_t savedY = y;
+    uint64_t product = mont.toMontgomery(1);
+    uint64_t divisor = 1;
+    for (uint64_t length = 1; divisor == 1; length *= 2) {
+        // x is the tortoise, parked at the start of each power of two long run of the hare y
+        x = y;
+        for (uint64_t i = 0; i < length; i++)
+            y = step(y);
+        for (uint64_t done = 0; done < length && divisor == 1; done += gcdBatchSize) {
+            savedY = y;
+            for (uint64_t i = 0; i < min(gcdBatchSize, length - done); i++) {
+                y = step(y);
+                product = mont.multiply(product, x > y ? x - y : y - x);
+            }
+            divisor = gcd(product, n);
+        }
+    }
+
+    // The batched product hit 0 mod n, so replays the last batch one step at a time to find the exact divisor
+    if (divisor == n) {
+        do {
+            savedY = step(savedY);
+            divisor = gcd(x > savedY ? x - savedY : savedY - x, n);
+        } while (divisor == 1);
+    }
+    return divisor;
+}
+
+/**
+ * Function that appends the prime factors of n to the passed in vector (n must not have any factor from smallPrimes)
+ */
+static void factorLarge(uint64_t n, vector<int64_t> &factors) {
+    if (n == 1)
+        return;
+    if (millerRabin(n)) {
+        factors.push_back(int64_t(n));
+        return;
+    }
+    uint64_t divisor = n;
+    for (uint64_t c = 1; divisor == n; c++)
+        divisor = pollardBrent(n, c);
+    factorLarge(divisor, factors);
+    factorLarge(n / divisor, factors);
+}
+
+std::vector<int64_t> factor_number(int64_t n) {
+    vector<int64_t> factors;
+    if (n < 2)
+        return factors;
+    uint64_t remaining = uint64_t(n);
+    for (uint64_t p : smallPrimes) {
+        while (remaining % p == 0) {
+            factors.push_back(int64_t(p));
+            remaining /= p;
+        }
+    }
+    factorLarge(remaining, factors);
+    sort(factors.begin(), factors.end());
+    return factors;
+}
+
+// Custom data struct that stores the state shared by the threads factoring a list of numbers
+struct FactorWork {
+    const vector<int64_t> *uniqueNumbers;
+    vector<vector<int64_t>> *factorizations;
+    // Index of the next unique number to factor
+    atomic<size_t> nextIndex{0};
+};
+
+/**
+ * Function that will be used by threads to perform their work (claims unique numbers one at a time until none are left)
+ * @param input - Pointer that will contain the FactorWork struct shared by all the threads
+ */
+static void *factorThreadWork(void *input) {
+    auto *work = (FactorWork *) input;
+    while (true) {
+        size_t index = work->nextIndex.fetch_add(1);
+        if (index >= work->uniqueNumbers->size())
+            break;
+        (*work->factorizations)[index] = factor_number((*work->uniqueNumbers)[index]);
+    }
+    return nullptr;
+}
+
+std::vector<std::vector<int64_t>> factor_numbers(const std::vector<int64_t> &nums, int n_threads) {
+    // Factors every distinct number only once
+    vector<int64_t> uniqueNumbers;
+    vector<size_t> slotOfNumber(nums.size());
+    unordered_map<int64_t, size_t> slots;
+    for (size_t index = 0; index < nums.size(); index++) {
+        auto inserted = slots.emplace(nums[index], uniqueNumbers.size());
+        if (inserted.second)
+            uniqueNumbers.push_back(nums[index]);
+        slotOfNumber[index] = inserted.first->second;
+    }
+
+    vector<vector<int64_t>> factorizations(uniqueNumbers.size());
+    FactorWork work;
+    work.uniqueNumbers = &uniqueNumbers;
+    work.factorizations = &factorizations;
+    if (n_threads <= 1)
+        factorThreadWork(&work);
+    else {
+        // Creates the threads and waits for them to run out of numbers
+        vector<pthread_t> threadsArray(n_threads);
+        for (auto &thread : threadsArray)
+            pthread_create(&thread, nullptr, factorThreadWork, (void *) &work);
+        for (auto &thread : threadsArray)
+            pthread_join(thread, nullptr);
+    }
+
+    // Maps the factorizations back to the input order
+    vector<vector<int64_t>> results(nums.size());
+    for (size_t index = 0; index < nums.size(); index++)
+        results[index] = factorizations[slotOfNumber[index]];
+    return results;
+}
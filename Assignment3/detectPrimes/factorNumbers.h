@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cinttypes>
+#include <vector>
+
+/**
+ * Function that computes the prime factorization of a single number using Pollard-rho (Brent's variant with Montgomery arithmetic)
+ * @param n - Number to factor (numbers below 2 have no prime factors)
+ * @return vector - Vector of the prime factors of n in increasing order (repeated according to their multiplicity)
+ */
+std::vector<int64_t> factor_number(int64_t n);
+
+/**
+ * Function that uses the provided nums (vector of numbers to factor) and n_threads (number of threads) to factor every number
+ * @param nums - Vector of 64 bit wide integers that will be factored
+ * @param n_threads - Max number of threads that can be utilized (the numbers are split between the threads)
+ * @return vector - Vector holding the factorization of each input number (same order as nums)
+ */
+std::vector<std::vector<int64_t>> factor_numbers(const std::vector<int64_t> &nums, int n_threads);
@@ -0,0 +1,205 @@
+#include "primeDetector.h"
+#include "primeKernels.h"
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+using namespace std;
+
+// Max number of unique numbers handed to a worker thread at once (keeps the locking overhead per item negligible)
+static constexpr size_t workItemSize = 4096;
+
+// Custom data struct that describes a piece of work that a worker thread can claim
+struct WorkItem {
+    // Range of unique number slots [firstSlot, lastSlot) that the item covers
+    size_t firstSlot;
+    size_t lastSlot;
+};
+
+struct PrimeDetector::Batch {
+    // Unique numbers of the batch that still need to be checked after the trivial checks
+    vector<int64_t> uniqueNumbers;
+
+    // Results of the unique numbers in the same slot (each slot is only ever written by the thread that claimed it)
+    unique_ptr<bool[]> isPrime;
+
+    // Pieces of work that the worker threads will claim
+    vector<WorkItem> workItems;
+
+    // Index of the next unclaimed work item (only accessed while holding the pool mutex)
+    size_t nextWorkItem = 0;
+
+    // Number of work items that have not been finished yet
+    atomic<size_t> workItemsRemaining{0};
+};
+
+/**
+ * Function that checks the primality of the unique numbers covered by a work item
+ * @note Numbers below 2^32 are checked 8 at a time by the batched trial division kernel, larger numbers by Miller-Rabin
+ * @param uniqueNumbers - Reference to the unique numbers of the batch
+ * @param isPrime - Pointer to the results of the unique numbers of the batch
+ * @param item - Work item to perform
+ */
+static void testWorkItem(const vector<int64_t> &uniqueNumbers, bool *isPrime, const WorkItem &item) {
+    vector<uint32_t> smallNumbers;
+    vector<size_t> smallSlots;
+    smallNumbers.reserve(item.lastSlot - item.firstSlot);
+    smallSlots.reserve(item.lastSlot - item.firstSlot);
+
+    // Checks the large numbers right away and gathers the small numbers so that they can be handed to the kernel together
+    for (size_t slot = item.firstSlot; slot < item.lastSlot; slot++) {
+        if (uniqueNumbers[slot] <= int64_t(UINT32_MAX)) {
+            smallNumbers.push_back(uint32_t(uniqueNumbers[slot]));
+            smallSlots.push_back(slot);
+        } else
+            isPrime[slot] = millerRabin(uint64_t(uniqueNumbers[slot]));
+    }
+    unique_ptr<bool[]> smallResults(new bool[smallNumbers.size()]);
+    testSmallBatch(smallNumbers.data(), smallNumbers.size(), smallResults.get());
+    for (size_t index = 0; index < smallNumbers.size(); index++)
+        isPrime[smallSlots[index]] = smallResults[index];
+}
+
+PrimeDetector::PrimeDetector(int n_threads) {
+    pthread_mutex_init(&poolMutex, nullptr);
+    pthread_cond_init(&workAvailable, nullptr);
+    pthread_cond_init(&batchFinished, nullptr);
+
+    // Creates the worker threads that make up the pool
+    workerThreads.resize(n_threads < 1 ? 1 : n_threads);
+    threadStats.resize(workerThreads.size());
+    for (auto &thread : workerThreads)
+        pthread_create(&thread, nullptr, threadWork, (void *) this);
+}
+
+PrimeDetector::~PrimeDetector() {
+    // Tells all the workers to exit and waits for them to do so
+    pthread_mutex_lock(&poolMutex);
+    shouldStop = true;
+    pthread_cond_broadcast(&workAvailable);
+    pthread_mutex_unlock(&poolMutex);
+    for (auto &thread : workerThreads)
+        pthread_join(thread, nullptr);
+
+    pthread_cond_destroy(&batchFinished);
+    pthread_cond_destroy(&workAvailable);
+    pthread_mutex_destroy(&poolMutex);
+}
+
+/**
+ * Function that will be used by the pool's threads to perform their work
+ * @param input - Pointer to the PrimeDetector object that owns the thread
+ */
+void *PrimeDetector::threadWork(void *input) {
+    ((PrimeDetector *) input)->workerLoop();
+    return nullptr;
+}
+
+/**
+ * Function that keeps claiming work items from the pending batches until the pool is stopped
+ */
+void PrimeDetector::workerLoop() {
+    pthread_mutex_lock(&poolMutex);
+    int workerIndex = workersStarted++;
+    while (true) {
+        // Sleeps until there is a batch to work on or the pool is stopping
+        while (!shouldStop && pendingBatches.empty())
+            pthread_cond_wait(&workAvailable, &poolMutex);
+        if (shouldStop)
+            break;
+
+        // Claims the next work item of the oldest batch and retires the batch from the queue once all its items are claimed
+        Batch *batch = pendingBatches.front();
+        WorkItem item = batch->workItems[batch->nextWorkItem++];
+        if (batch->nextWorkItem == batch->workItems.size())
+            pendingBatches.pop_front();
+        pthread_mutex_unlock(&poolMutex);
+
+        // Checks the numbers covered by the claimed item
+        auto itemStart = chrono::steady_clock::now();
+        testWorkItem(batch->uniqueNumbers, batch->isPrime.get(), item);
+        chrono::duration<double> itemTime = chrono::steady_clock::now() - itemStart;
+
+        // Records the work done and wakes up the caller if this was the last unfinished item of the batch
+        pthread_mutex_lock(&poolMutex);
+        threadStats[workerIndex].workItems++;
+        threadStats[workerIndex].numbersTested += item.lastSlot - item.firstSlot;
+        threadStats[workerIndex].busySeconds += itemTime.count();
+        if (batch->workItemsRemaining.fetch_sub(1) == 1)
+            pthread_cond_broadcast(&batchFinished);
+    }
+    pthread_mutex_unlock(&poolMutex);
+}
+
+vector<PrimeDetector::ThreadStats> PrimeDetector::stats() {
+    pthread_mutex_lock(&poolMutex);
+    vector<ThreadStats> result = threadStats;
+    pthread_mutex_unlock(&poolMutex);
+    return result;
+}
+
+void PrimeDetector::resetStats() {
+    pthread_mutex_lock(&poolMutex);
+    for (auto &stats : threadStats)
+        stats = ThreadStats();
+    pthread_mutex_unlock(&poolMutex);
+}
+
+/**
+ * Function that uses the provided span of numbers and checks their primality using the pool's threads
+ * @note Implements code from detectPrimes (https://gitlab.com/cpsc457/public/detectPrimes)
+ * @param nums - Pointer to the first number of the span that will have its primality checked for
+ * @param count - Number of numbers in the span
+ * @return vector - Vector of 64 bit wide integers that are prime numbers from the passed in span
+ */
+vector<int64_t> PrimeDetector::detect(const int64_t *nums, size_t count) {
+    Batch batch;
+
+    // Stores the slot of every input number (-1 = not prime from the trivial checks, -2 = prime from the trivial checks)
+    vector<int64_t> slotOfNumber(count);
+
+    // Initialize an unordered map that will store the slot of each unique number (to skip having to check duplicate numbers)
+    unordered_map<int64_t, int64_t> checkedNumbers;
+
+    // Performs all the trivial checks and assigns a slot to each unique number that still needs trial division
+    for (size_t index = 0; index < count; index++) {
+        int64_t currentNumber = nums[index];
+        if (currentNumber < 2 || (currentNumber > 3 && (currentNumber % 2 == 0 || currentNumber % 3 == 0)))
+            slotOfNumber[index] = -1;
+        else if (currentNumber < 25)
+            slotOfNumber[index] = -2;
+        else {
+            auto inserted = checkedNumbers.emplace(currentNumber, int64_t(batch.uniqueNumbers.size()));
+            if (inserted.second)
+                batch.uniqueNumbers.push_back(currentNumber);
+            slotOfNumber[index] = inserted.first->second;
+        }
+    }
+    batch.isPrime.reset(new bool[batch.uniqueNumbers.size()]);
+
+    // Splits the unique numbers into work items so that every thread gets a few of them
+    size_t itemSize = (batch.uniqueNumbers.size() + 4 * threads() - 1) / (4 * threads());
+    itemSize = min(workItemSize, max(size_t(1), itemSize));
+    for (size_t slot = 0; slot < batch.uniqueNumbers.size(); slot += itemSize)
+        batch.workItems.push_back({slot, min(batch.uniqueNumbers.size(), slot + itemSize)});
+
+    // Hands the batch to the pool and waits until all its work items are finished
+    if (!batch.workItems.empty()) {
+        batch.workItemsRemaining = batch.workItems.size();
+        pthread_mutex_lock(&poolMutex);
+        pendingBatches.push_back(&batch);
+        pthread_cond_broadcast(&workAvailable);
+        while (batch.workItemsRemaining != 0)
+            pthread_cond_wait(&batchFinished, &poolMutex);
+        pthread_mutex_unlock(&poolMutex);
+    }
+
+    // Populates the result vector in input order
+    vector<int64_t> results;
+    for (size_t index = 0; index < count; index++)
+        if (slotOfNumber[index] == -2 || (slotOfNumber[index] >= 0 && batch.isPrime[slotOfNumber[index]]))
+            results.push_back(nums[index]);
+    return results;
+}
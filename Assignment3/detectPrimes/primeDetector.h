@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <deque>
+#include <pthread.h>
+#include <vector>
+
+/**
+ * Class that owns a persistent pool of worker threads which are used to check the primality of batches of numbers
+ * @note Every call to detect() is handled as its own batch (no global state is shared between calls) so multiple threads can call detect() on the same object concurrently
+ */
+class PrimeDetector {
+public:
+    // Custom data struct that stores how much work a single worker thread did since the last resetStats()
+    struct ThreadStats {
+        // Number of work items the thread claimed
+        uint64_t workItems = 0;
+        // Number of unique numbers the thread checked
+        uint64_t numbersTested = 0;
+        // Time (in seconds) the thread spent checking numbers (the rest of the time it was waiting for work)
+        double busySeconds = 0;
+    };
+
+    /**
+     * Constructor that spawns the worker threads (they are kept alive until the object is destroyed)
+     * @param n_threads - Number of worker threads to create (values below 1 are treated as 1)
+     */
+    explicit PrimeDetector(int n_threads);
+
+    /**
+     * Destructor that stops and joins all the worker threads
+     */
+    ~PrimeDetector();
+
+    PrimeDetector(const PrimeDetector &) = delete;
+
+    PrimeDetector &operator=(const PrimeDetector &) = delete;
+
+    /**
+     * Function that checks the primality of a span of numbers using the worker threads (blocks until the batch is done)
+     * @param nums - Pointer to the first number of the span that will have its primality checked for
+     * @param count - Number of numbers in the span
+     * @return vector - Vector of 64 bit wide integers that are prime numbers from the passed in span (in input order, duplicates included)
+     */
+    std::vector<int64_t> detect(const int64_t *nums, size_t count);
+
+    /**
+     * Function that checks the primality of all the numbers in the passed in vector (see the span version of detect())
+     * @param nums - Vector of 64 bit wide integers that will have their primality checked for
+     * @return vector - Vector of 64 bit wide integers that are prime numbers from the passed in vector
+     */
+    std::vector<int64_t> detect(const std::vector<int64_t> &nums) { return detect(nums.data(), nums.size()); }
+
+    /**
+     * Function that returns the number of worker threads owned by the object
+     * @return int - Number of worker threads in the pool
+     */
+    int threads() const { return int(workerThreads.size()); }
+
+    /**
+     * Function that returns a snapshot of the work done by each worker thread since construction or the last resetStats()
+     * @return vector - Vector of ThreadStats, one per worker thread
+     */
+    std::vector<ThreadStats> stats();
+
+    /**
+     * Function that sets the work counters of all the worker threads back to 0
+     */
+    void resetStats();
+
+private:
+    // Per call state (defined in primeDetector.cpp)
+    struct Batch;
+
+    // Worker threads that make up the pool
+    std::vector<pthread_t> workerThreads;
+
+    // Mutex guarding the pending batches queue and the stop flag
+    pthread_mutex_t poolMutex;
+
+    // Condition variable used to wake up the workers when a new batch is submitted (or the pool is stopping)
+    pthread_cond_t workAvailable;
+
+    // Condition variable used to wake up the callers that are waiting on their batch to finish
+    pthread_cond_t batchFinished;
+
+    // Batches that still have unclaimed work items
+    std::deque<Batch *> pendingBatches;
+
+    // Boolean that will tell the workers to exit
+    bool shouldStop = false;
+
+    // Work done by each worker thread (only accessed while holding the pool mutex)
+    std::vector<ThreadStats> threadStats;
+
+    // Number of workers that have picked their index into threadStats
+    int workersStarted = 0;
+
+    static void *threadWork(void *input);
+
+    void workerLoop();
+};
@@ -0,0 +1,170 @@
+#include "primeKernels.h"
+#include <immintrin.h>
+#include <vector>
+
+using namespace std;
+
+// Custom data struct that stores every prime below 2^16 alongside the constant used to check divisibility by it without a division
+struct DivisorTable {
+    vector<uint32_t> primes;
+    // magic[i] = ceil(2^64 / primes[i]), n is divisible by primes[i] iff n * magic[i] (mod 2^64) <= magic[i] - 1 (Lemire et al., "Faster Remainder by Direct Computation")
+    vector<uint64_t> magic;
+};
+
+/**
+ * Function that builds the divisor table the first time it is needed (thread safe as it is a function local static)
+ * @return DivisorTable - Reference to the table of primes below 2^16 (enough to check any number below 2^32)
+ */
+static const DivisorTable &divisorTable() {
+    static const DivisorTable table = [] {
+        DivisorTable result;
+        vector<bool> composite(1 << 16, false);
+        for (uint32_t i = 2; i < composite.size(); i++) {
+            if (composite[i])
+                continue;
+            result.primes.push_back(i);
+            result.magic.push_back(UINT64_MAX / i + 1);
+            for (uint32_t j = i * i; j < composite.size(); j += i)
+                composite[j] = true;
+        }
+        return result;
+    }();
+    return table;
+}
+
+/**
+ * Function that checks the primality of a single number below 2^32 with the divisor table
+ * @param n - Number to check the primality of
+ * @param table - Reference to the divisor table
+ * @return bool - Boolean of whether or not the passed in number is prime
+ */
+static bool testSmallScalar(uint64_t n, const DivisorTable &table) {
+    if (n < 2)
+        return false;
+    for (size_t i = 0; i < table.primes.size(); i++) {
+        uint64_t p = table.primes[i];
+        if (p * p > n)
+            break;
+        if (n * table.magic[i] <= table.magic[i] - 1)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Function that checks the primality of 8 numbers below 2^32 at once using two vectors of 4 64 bit lanes
+ * @param nums - Pointer to the 8 numbers to check
+ * @param isPrime - Pointer to an array of 8 booleans that will store the results
+ * @param table - Reference to the divisor table
+ */
+__attribute__((target("avx2")))
+static void testSmallAvx2(const uint32_t *nums, bool *isPrime, const DivisorTable &table) {
+    // Flipping the sign bit lets the signed 64 bit compare of AVX2 do an unsigned compare
+    const __m256i signBit = _mm256_set1_epi64x(INT64_MIN);
+    __m256i numbers[2];
+    __m256i composite[2];
+    __m256i finished[2];
+    for (int half = 0; half < 2; half++) {
+        numbers[half] = _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *) (nums + half * 4)));
+        composite[half] = _mm256_cmpgt_epi64(_mm256_set1_epi64x(2), numbers[half]);
+        finished[half] = composite[half];
+    }
+
+    for (size_t i = 0; i < table.primes.size(); i++) {
+        uint64_t p = table.primes[i];
+        const __m256i squared = _mm256_set1_epi64x(int64_t(p * p));
+        const __m256i magic = _mm256_set1_epi64x(int64_t(table.magic[i]));
+        const __m256i magicHigh = _mm256_srli_epi64(magic, 32);
+        const __m256i limit = _mm256_xor_si256(_mm256_set1_epi64x(int64_t(table.magic[i] - 1)), signBit);
+        int finishedLanes = 0;
+        for (int half = 0; half < 2; half++) {
+            // Lanes whose square root is below p are done (and prime unless a divisor was found already)
+            finished[half] = _mm256_or_si256(finished[half], _mm256_cmpgt_epi64(squared, numbers[half]));
+
+            // Computes the low 64 bits of n * magic from two 32 x 32 bit products since n fits into 32 bits
+            __m256i product = _mm256_add_epi64(_mm256_mul_epu32(numbers[half], magic),
+                                               _mm256_slli_epi64(_mm256_mul_epu32(numbers[half], magicHigh), 32));
+            __m256i divisible = _mm256_andnot_si256(_mm256_cmpgt_epi64(_mm256_xor_si256(product, signBit), limit),
+                                                    _mm256_set1_epi64x(-1));
+            divisible = _mm256_andnot_si256(finished[half], divisible);
+            composite[half] = _mm256_or_si256(composite[half], divisible);
+            finished[half] = _mm256_or_si256(finished[half], divisible);
+            finishedLanes |= _mm256_movemask_pd(_mm256_castsi256_pd(finished[half])) << (half * 4);
+        }
+        // Stops as soon as every lane has been decided
+        if (finishedLanes == 0xFF)
+            break;
+    }
+
+    for (int half = 0; half < 2; half++) {
+        int compositeLanes = _mm256_movemask_pd(_mm256_castsi256_pd(composite[half]));
+        for (int lane = 0; lane < 4; lane++)
+            isPrime[half * 4 + lane] = !(compositeLanes & (1 << lane));
+    }
+}
+
+void testSmallBatch(const uint32_t *nums, size_t count, bool *isPrime) {
+    const DivisorTable &table = divisorTable();
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    size_t index = 0;
+    if (hasAvx2) {
+        for (; index + 8 <= count; index += 8)
+            testSmallAvx2(nums + index, isPrime + index, table);
+    }
+    for (; index < count; index++)
+        isPrime[index] = testSmallScalar(nums[index], table);
+}
+
+/**
+ * Function that computes (a * b) mod n without overflowing
+ */
+static uint64_t mulMod(uint64_t a, uint64_t b, uint64_t n) {
+    return uint64_t((unsigned __int128) a * b % n);
+}
+
+/**
+ * Function that computes (base ^ exponent) mod n by repeated squaring
+ */
+static uint64_t powMod(uint64_t base, uint64_t exponent, uint64_t n) {
+    uint64_t result = 1;
+    base %= n;
+    while (exponent) {
+        if (exponent & 1)
+            result = mulMod(result, base, n);
+        base = mulMod(base, base, n);
+        exponent >>= 1;
+    }
+    return result;
+}
+
+bool millerRabin(uint64_t n) {
+    // The first 12 primes as bases are enough to make the test deterministic for every 64 bit wide number
+    static const uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+    if (n < 2)
+        return false;
+    for (uint64_t p : bases)
+        if (n % p == 0)
+            return n == p;
+
+    // Writes n - 1 as d * 2^s with d odd
+    uint64_t d = n - 1;
+    int s = 0;
+    while ((d & 1) == 0) {
+        d >>= 1;
+        s++;
+    }
+    for (uint64_t a : bases) {
+        uint64_t x = powMod(a, d, n);
+        if (x == 1 || x == n - 1)
+            continue;
+        bool witness = true;
+        for (int r = 1; r < s && witness; r++) {
+            x = mulMod(x, x, n);
+            if (x == n - 1)
+                witness = false;
+        }
+        if (witness)
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+
+/**
+ * Function that checks the primality of a batch of numbers below 2^32 by dividing them by every prime up to their square root
+ * @note Uses an AVX2 kernel that tests 8 numbers at a time when the CPU supports it (chosen at runtime), and a scalar loop otherwise
+ * @param nums - Pointer to the numbers to check (all must be below 2^32)
+ * @param count - Number of numbers to check
+ * @param isPrime - Pointer to an array of count booleans that will store the result of each number
+ */
+void testSmallBatch(const uint32_t *nums, size_t count, bool *isPrime);
+
+/**
+ * Function that checks the primality of any 64 bit wide number with a deterministic Miller-Rabin test
+ * @param n - Number to check the primality of
+ * @return bool - Boolean of whether or not the passed in number is prime (False = not prime, True = prime)
+ */
+bool millerRabin(uint64_t n);
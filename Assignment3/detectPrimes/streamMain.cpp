@@ -0,0 +1,38 @@
+#include "streamPrimes.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * Entry point of the streaming mode, kept apart from main.cpp so the assignment driver stays untouched
+ * @note Usage: detectPrimesStream [nThreads], the numbers are read from stdin and the primes are printed while it is still being read
+ */
+int main(int argc, char **argv) {
+    int nThreads = 1;
+    if (argc != 1 && argc != 2) {
+        cout << "Usage: " << argv[0] << " [nThreads]\n"
+             << "    the default for nThreads is 1 thread.\n"
+             << "    prints the primes while stdin is still being read.\n";
+        exit(-1);
+    }
+    if (argc == 2)
+        nThreads = atoi(argv[1]);
+    if (nThreads < 1 || nThreads > 256) {
+        cout << "Bad arguments. 1 <= nThreads <= 256!\n";
+        exit(-1);
+    }
+    cout << "Using " << nThreads << " thread" << (nThreads == 1 ? "" : "s") << ".\n" << flush;
+
+    // Parses, tests and prints in a pipeline with bounded memory (the primes go straight to stdout)
+    auto start = chrono::steady_clock::now();
+    int64_t count = stream_primes(STDIN_FILENO, stdout, nThreads);
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "Identified " << count << " primes.\n"
+         << "\nFinished in " << fixed << setprecision(4) << elapsed << "s\n";
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include "streamPrimes.h"
+#include "primeDetector.h"
+#include <pthread.h>
+#include <unistd.h>
+#include <cctype>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Size of the blocks that are read from the input in one system call
+static constexpr size_t readBlockSize = 1 << 20;
+
+// Number of numbers handed to the pool at once
+static constexpr size_t batchSize = 1 << 16;
+
+// Max number of batches that can be in the pipeline at once (bounds the memory used by the pipeline)
+static constexpr size_t maxBatchesInFlight = 8;
+
+// Number of threads that submit batches to the pool (more than 1 lets the pool start on the next batch while the previous one finishes)
+static constexpr int testerThreads = 2;
+
+// Max width of an output line (not counting the 2 leading spaces), matches the non streaming output
+static constexpr size_t maxLineWidth = 77;
+
+// Custom data struct that stores a batch of numbers as it moves through the pipeline
+struct StreamBatch {
+    size_t sequenceNumber;
+    vector<int64_t> numbers;
+    vector<int64_t> primes;
+};
+
+// Custom data struct that stores the state shared by all the stages of the pipeline
+struct StreamState {
+    int inputFd;
+    PrimeDetector *detector;
+
+    pthread_mutex_t mutex;
+    // Signalled when a batch was parsed, tested or written (or the parser finished)
+    pthread_cond_t changed;
+
+    // Batches that were parsed but not tested yet
+    deque<StreamBatch *> parsedBatches;
+    // Batches that were tested but not written yet, keyed by their sequence number
+    map<size_t, StreamBatch *> testedBatches;
+    // Number of batches created but not written yet
+    size_t batchesInFlight = 0;
+    // Total number of batches created by the parser (only final once parserDone is set)
+    size_t batchesCreated = 0;
+    bool parserDone = false;
+};
+
+/**
+ * Function that hands a parsed batch to the testers (blocks while the pipeline is full)
+ * @param state - Pointer to the shared pipeline state
+ * @param batch - Pointer to the batch that was parsed
+ */
+static void publishBatch(StreamState *state, StreamBatch *batch) {
+    pthread_mutex_lock(&state->mutex);
+    while (state->batchesInFlight >= maxBatchesInFlight)
+        pthread_cond_wait(&state->changed, &state->mutex);
+    batch->sequenceNumber = state->batchesCreated++;
+    state->batchesInFlight++;
+    state->parsedBatches.push_back(batch);
+    pthread_cond_broadcast(&state->changed);
+    pthread_mutex_unlock(&state->mutex);
+}
+
+/**
+ * Function that will be used by the parser thread to convert the input into batches of numbers
+ * @param input - Pointer to the shared pipeline state
+ */
+static void *parserWork(void *input) {
+    auto *state = (StreamState *) input;
+    vector<char> block(readBlockSize);
+    auto *batch = new StreamBatch;
+    batch->numbers.reserve(batchSize);
+
+    // State of the token being parsed (kept across blocks since a number can straddle two reads)
+    uint64_t value = 0;
+    bool inNumber = false;
+    bool negative = false;
+    bool sawDigit = false;
+    bool stop = false;
+
+    // Adds the token parsed so far to the batch and hands the batch over once it is full
+    auto emitNumber = [&]() {
+        batch->numbers.push_back(negative ? int64_t(0 - value) : int64_t(value));
+        value = 0;
+        inNumber = negative = sawDigit = false;
+        if (batch->numbers.size() == batchSize) {
+            publishBatch(state, batch);
+            batch = new StreamBatch;
+            batch->numbers.reserve(batchSize);
+        }
+    };
+
+    while (!stop) {
+        ssize_t bytesRead = read(state->inputFd, block.data(), block.size());
+        // Treats EOF as one final whitespace so that a number at the very end of the input is flushed
+        bool atEnd = bytesRead <= 0;
+        if (atEnd) {
+            block[0] = ' ';
+            bytesRead = 1;
+        }
+
+        for (const char *current = block.data(), *end = current + bytesRead; current < end; current++) {
+            char c = *current;
+            if (c >= '0' && c <= '9') {
+                // Stops at numbers that do not fit into 64 bits (std::cin would fail on them too)
+                uint64_t limit = negative ? uint64_t(INT64_MAX) + 1 : uint64_t(INT64_MAX);
+                if (value > (limit - (c - '0')) / 10) {
+                    stop = true;
+                    break;
+                }
+                value = value * 10 + (c - '0');
+                inNumber = sawDigit = true;
+                continue;
+            }
+            // Any other character ends the current number (std::cin >> num keeps the digits read before it)
+            if (inNumber && sawDigit)
+                emitNumber();
+            if ((c == '-' || c == '+') && !inNumber) {
+                negative = c == '-';
+                inNumber = true;
+            } else if (inNumber || !isspace((unsigned char) c)) {
+                stop = true;
+                break;
+            }
+        }
+        if (atEnd)
+            break;
+    }
+
+    // Publishes the last partially filled batch and lets the other stages know that no more batches are coming
+    if (!batch->numbers.empty())
+        publishBatch(state, batch);
+    else
+        delete batch;
+    pthread_mutex_lock(&state->mutex);
+    state->parserDone = true;
+    pthread_cond_broadcast(&state->changed);
+    pthread_mutex_unlock(&state->mutex);
+    return nullptr;
+}
+
+/**
+ * Function that will be used by the tester threads to submit parsed batches to the pool
+ * @param input - Pointer to the shared pipeline state
+ */
+static void *testerWork(void *input) {
+    auto *state = (StreamState *) input;
+    pthread_mutex_lock(&state->mutex);
+    while (true) {
+        while (state->parsedBatches.empty() && !state->parserDone)
+            pthread_cond_wait(&state->changed, &state->mutex);
+        if (state->parsedBatches.empty())
+            break;
+        StreamBatch *batch = state->parsedBatches.front();
+        state->parsedBatches.pop_front();
+        pthread_mutex_unlock(&state->mutex);
+
+        // Checks the batch and frees its numbers right away since only the primes are needed from now on
+        batch->primes = state->detector->detect(batch->numbers);
+        vector<int64_t>().swap(batch->numbers);
+
+        pthread_mutex_lock(&state->mutex);
+        state->testedBatches[batch->sequenceNumber] = batch;
+        pthread_cond_broadcast(&state->changed);
+    }
+    pthread_mutex_unlock(&state->mutex);
+    return nullptr;
+}
+
+/**
+ * Function that appends the decimal representation of a number to a buffer (without going through std::string)
+ * @param number - Number to convert
+ * @param buffer - Pointer to a buffer of at least 20 characters
+ * @return size_t - Number of characters written
+ */
+static size_t formatNumber(int64_t number, char *buffer) {
+    char digits[20];
+    size_t length = 0;
+    uint64_t magnitude = number < 0 ? 0 - uint64_t(number) : uint64_t(number);
+    do {
+        digits[length++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    size_t written = 0;
+    if (number < 0)
+        buffer[written++] = '-';
+    while (length)
+        buffer[written++] = digits[--length];
+    return written;
+}
+
+int64_t stream_primes(int inputFd, FILE *output, int n_threads) {
+    PrimeDetector detector(n_threads);
+    StreamState state;
+    state.inputFd = inputFd;
+    state.detector = &detector;
+    pthread_mutex_init(&state.mutex, nullptr);
+    pthread_cond_init(&state.changed, nullptr);
+
+    // Starts the parser and tester stages (the calling thread acts as the output stage)
+    pthread_t parserThread;
+    pthread_t testerThreadsArray[testerThreads];
+    pthread_create(&parserThread, nullptr, parserWork, (void *) &state);
+    for (auto &thread : testerThreadsArray)
+        pthread_create(&thread, nullptr, testerWork, (void *) &state);
+
+    int64_t primesWritten = 0;
+    string outputBuffer;
+    char line[maxLineWidth + 32];
+    size_t lineLength = 0;
+
+    // Writes the batches out in input order as soon as they become available
+    pthread_mutex_lock(&state.mutex);
+    for (size_t nextSequence = 0;; nextSequence++) {
+        while (state.testedBatches.count(nextSequence) == 0
+               && !(state.parserDone && nextSequence == state.batchesCreated))
+            pthread_cond_wait(&state.changed, &state.mutex);
+        if (state.testedBatches.count(nextSequence) == 0)
+            break;
+        StreamBatch *batch = state.testedBatches[nextSequence];
+        state.testedBatches.erase(nextSequence);
+        pthread_mutex_unlock(&state.mutex);
+
+        for (auto prime : batch->primes) {
+            char number[21];
+            size_t numberLength = formatNumber(prime, number);
+            if (lineLength != 0 && lineLength + 1 + numberLength > maxLineWidth) {
+                outputBuffer.append("  ").append(line, lineLength).push_back('\n');
+                lineLength = 0;
+            }
+            if (lineLength != 0)
+                line[lineLength++] = ' ';
+            memcpy(line + lineLength, number, numberLength);
+            lineLength += numberLength;
+        }
+        primesWritten += int64_t(batch->primes.size());
+        delete batch;
+        if (outputBuffer.size() >= readBlockSize) {
+            fwrite(outputBuffer.data(), 1, outputBuffer.size(), output);
+            outputBuffer.clear();
+        }
+
+        pthread_mutex_lock(&state.mutex);
+        state.batchesInFlight--;
+        pthread_cond_broadcast(&state.changed);
+    }
+    pthread_mutex_unlock(&state.mutex);
+    if (lineLength != 0)
+        outputBuffer.append("  ").append(line, lineLength).push_back('\n');
+    fwrite(outputBuffer.data(), 1, outputBuffer.size(), output);
+    fflush(output);
+
+    // Garbage collects the pipeline threads
+    pthread_join(parserThread, nullptr);
+    for (auto &thread : testerThreadsArray)
+        pthread_join(thread, nullptr);
+    pthread_cond_destroy(&state.changed);
+    pthread_mutex_destroy(&state.mutex);
+    return primesWritten;
+}
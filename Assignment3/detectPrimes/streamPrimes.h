@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstdio>
+
+/**
+ * Function that reads whitespace separated numbers from the passed in file descriptor and writes the primes among them to the passed in stream while the input is still being read
+ * @note A parser thread, the PrimeDetector pool and the calling thread (output stage) run as a pipeline over bounded batches so memory use does not grow with the input size
+ * @param inputFd - File descriptor to read the numbers from (reading stops at EOF or at the first token that is not a 64 bit wide integer, like std::cin would)
+ * @param output - Stream that the primes are written to (in input order, wrapped the same way as the non streaming output)
+ * @param n_threads - Number of threads used to check the primality of the numbers
+ * @return int64_t - Number of primes that were written
+ */
+int64_t stream_primes(int inputFd, FILE *output, int n_threads);
@@ -0,0 +1,89 @@
+#include "calcpiExt.h"
+#include "pixelKernels.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Custom data struct that stores a kernel alongside the largest radius it is benchmarked at
+struct NamedKernel {
+    string name;
+    ColumnKernel kernel;
+    int maxRadius;
+};
+
+static void usage(const char *pname) {
+    cout << "Usage: " << pname << " [maxThreads] [maxRadius] [maxBruteRadius]\n"
+         << "    maxThreads defaults to 8, maxRadius to 100000 and maxBruteRadius\n"
+         << "    (largest radius the O(r^2) kernels are run at) to 20000\n";
+    exit(-1);
+}
+
+int main(int argc, char **argv) {
+    int maxThreads = 8;
+    int maxRadius = 100000;
+    int maxBruteRadius = 20000;
+    if (argc >= 2) maxThreads = atoi(argv[1]);
+    if (argc >= 3) maxRadius = atoi(argv[2]);
+    if (argc >= 4) maxBruteRadius = atoi(argv[3]);
+    if (argc > 4 || maxThreads < 1 || maxThreads > 256 || maxRadius < 1 || maxBruteRadius < 0) usage(argv[0]);
+
+    vector<NamedKernel> kernels{{"brute",    countColumnsBruteForce,     maxBruteRadius},
+                                {"simd",     countColumnsBruteForceSimd, maxBruteRadius},
+                                {"boundary", countColumnsBoundary,       maxRadius}};
+
+    // Radii to try: powers of ten up to maxRadius, plus maxRadius itself
+    vector<int> radii;
+    for (int r = 1; r < maxRadius; r *= 10)
+        radii.push_back(r);
+    radii.push_back(maxRadius);
+
+    // Thread counts to try: powers of two up to maxThreads, plus maxThreads itself
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    cout << "kernel,radius,threads,count,seconds,pixels_per_second,speedup,efficiency,matches\n";
+    cout << fixed << setprecision(6);
+    int mismatches = 0;
+    for (int r : radii) {
+        // The 128 bit wide kernel is the reference every other kernel has to agree with
+        unsigned __int128 expected = count_pixels_large(r, 1);
+
+        for (auto &named : kernels) {
+            if (r > named.maxRadius)
+                continue;
+            double baseline = 0;
+            for (int threads : threadCounts) {
+                // Runs once untimed so that the pool for this thread count already exists
+                count_pixels(1, threads, named.kernel);
+                auto start = chrono::steady_clock::now();
+                uint64_t count = count_pixels(r, threads, named.kernel);
+                double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+                if (threads == 1)
+                    baseline = seconds;
+                bool matches = count == expected;
+                if (!matches)
+                    mismatches++;
+
+                // Pixels per second counts the whole quadrant grid, so all kernels are measured on the same scale
+                double pixels = double(r) * (r + 1);
+                double speedup = seconds > 0 ? baseline / seconds : 0;
+                cout << named.name << "," << r << "," << threads << "," << count << "," << seconds << ","
+                     << (seconds > 0 ? pixels / seconds : 0) << "," << speedup << "," << speedup / threads << ","
+                     << (matches ? "yes" : "no") << "\n";
+            }
+        }
+    }
+
+    if (mismatches) {
+        cerr << mismatches << " run(s) did not match the reference count!\n";
+        return 1;
+    }
+    return 0;
+}
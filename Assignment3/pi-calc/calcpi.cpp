@@ -1,121 +1,109 @@
-#include "calcpi.h"
-#include <pthread.h>
-#include <cmath>
+#include "calcpiExt.h"
+#include "columnPool.h"
+#include <algorithm>
 
 using namespace std;
 
-// Initialize an integer that will store the r value
-int radius = 0;
+// Number of chunks each thread gets on average (more chunks balance the load better, fewer keep the counter contention down)
+static constexpr int64_t chunksPerThread = 16;
 
-// Initialize a double that will store the r^2 value as a double (retains decimal places)
-double radiusSquared = 0;
-
-// Custom data struct that will store the parameters used for each thread's work
-struct threadParameters {
-    double startX;
-    double endX;
-};
-
-/**
- * Function that will be used by threads to perform their work
- * @param input - Pointer that will contain the threadParameters struct to pass in input to the thread
- * @return uint64_t - Pointer to an unsigned 64 bit wide integer that will store the result from the thread's work
- */
-void *threadWork(void *input) {
-    // Initialize a local counter to that will store the result that will be returned
-    uint64_t counter = 0;
-
-    // Loop that runs within the start and end bounds passed in through the data struct
-    for (double x = ((threadParameters *) input)->startX; x <= ((threadParameters *) input)->endX; x++)
-        // Loop that runs radius + 1 number of times
-        for (double y = 0; y <= radius; y++)
-            // Checks to see if (x^2 + y^2) <= radius^2 and increments the local counter if it is
-            if (x * x + y * y <= radiusSquared)
-                counter++;
-    // Returns the local counter back to the calling code
-    return (void *) counter;
-}
+// Smallest number of columns handed to a thread at once
+static constexpr int64_t minChunkSize = 256;
 
 /**
  * Function that uses the provided r (radius) and n_threads (number of threads) to count the number of pixels the area of a circle would encompass (implements https://en.wikipedia.org/wiki/Approximations_of_π#Summing_a_circle's_area )
- * @note Implements code from pi-calc (https://gitlab.com/cpsc457/public/pi-calc) and Gabriela Wcislo's simple_pthread.cpp and thread_sum.cpp from w3d2_code
+ * @note Implements code from pi-calc (https://gitlab.com/cpsc457/public/pi-calc) on top of a persistent ColumnPool that hands out chunks of columns dynamically
  * @param r - Radius of the circle
  * @param n_threads - Max number of threads that can be utilized
+ * @param kernel - Function used to count the pixels of each chunk of columns
  * @return uint64_t - Unsigned 64 bit wide integer that will store the number of pixels that were encompassed by the circle's area
  */
-uint64_t count_pixels(int r, int n_threads) {
+uint64_t count_pixels(int r, int n_threads, ColumnKernel kernel) {
     // Returns 0 if r is 0
     if (r <= 0)
         return 0;
 
-    // Stores the passed in r value
-    radius = r;
-
-    // Stores the radius^2 value as a double (retains decimal places)
-    radiusSquared = double(radius) * radius;
-
-    // Initialize an unsigned 64 bit wide integer counter that will store the final result
-    uint64_t resultCounter = 0;
-
-    // Initialize integers that will store the number of threads that will be used and how much work per thread will be assigned
-    int threadsNeeded;
-    uint64_t workPerThread;
-
-    // Calculates the number of runs of the outer loop that each thread needs to do (using ceiling to round up so we have an excess of threads leftover in the best case)
-    workPerThread = int(ceil((double(radius) / n_threads)));
+    // Splits the columns (x starts at 1 and ends at radius) into chunks that the pool's threads claim one at a time
+    ColumnPool &pool = sharedColumnPool(n_threads);
+    int64_t chunkSize = max(minChunkSize, int64_t(r) / (chunksPerThread * pool.threads()) + 1);
+    uint64_t resultCounter = uint64_t(pool.run(1, r, chunkSize, [r, kernel](int64_t firstX, int64_t lastX) {
+        return (unsigned __int128) kernel(r, firstX, lastX);
+    }));
 
-    // Determines how many threads are necessary based on the workload we have in case we have more threads available than work that needs to be done (using floor to push off the excess work at the very end to a spare thread)
-    threadsNeeded = int(floor((double(radius) / workPerThread)));
-
-    // Determines if an excess thread will be needed based on if there is work left after all threads finish and will allocate it into the thread pool if required
-    if ((radius - (workPerThread * threadsNeeded)) != 0)
-        threadsNeeded++;
-
-    // Creates an array of threads based on the required number of threads that was computed
-    pthread_t threadsArray[threadsNeeded];
-
-    // If the code was specified to run on a single thread then runs the provided code as is otherwise calls the multi-threaded code
-    if (n_threads == 1) {
-        // Loop that runs radius number of times (x starts at 1 and ends at radius) so runs n(INSIDE) times
-        for (double x = 1; x <= radius; x++)
-            // Loop that runs radius + 1 number of times (starts at 0 and ends at radius) so runs OUTSIDE(n+1) times
-            for (double y = 0; y <= radius; y++)
-                // Checks to see if (x^2 + y^2) <= radius^2 and increments the resultCounter if it is so runs n(n+1) times
-                if (x * x + y * y <= radiusSquared)
-                    resultCounter++;
-    } else {
-        // Integers to store the current x bounds being worked on by the threads
-        double startX = 1;
-        double endX = workPerThread;
-
-        // Loop to assign work to each of the threads
-        for (int currentThreadIndex = 0; currentThreadIndex < threadsNeeded; currentThreadIndex++) {
-            // Creates a thread based on the current x bounds that need to be worked on
-            pthread_create(&threadsArray[currentThreadIndex], nullptr, threadWork,
-                           (void *) new threadParameters{startX, endX});
-
-            // Adjusts the x bounds in preparation of the next thread
-            startX += workPerThread;
-            endX += workPerThread;
-
-            // If the x upper bound is greater than the radius then sets it to be the radius
-            if (endX > radius)
-                endX = radius;
-        }
+    // Returns 4 times the value of the result counter as there are 4 quadrants when dealing with a grid (and we only solved for one quadrant as the rest are similar)
+    return resultCounter * 4 + 1;
+}
 
-        // Loop to garbage collect all the threads
-        for (int currentThreadIndex = 0; currentThreadIndex < threadsNeeded; currentThreadIndex++) {
-            // Creates a pointer that will store the thread's counter result
-            void *threadResult = 0;
+/**
+ * Function that counts the pixels with the O(r) boundary kernel (see the kernel version of count_pixels())
+ * @param r - Radius of the circle
+ * @param n_threads - Max number of threads that can be utilized
+ * @return uint64_t - Unsigned 64 bit wide integer that will store the number of pixels that were encompassed by the circle's area
+ */
+uint64_t count_pixels(int r, int n_threads) {
+    return count_pixels(r, n_threads, countColumnsBoundary);
+}
 
-            // Closes the thread and stores its returned result
-            pthread_join(threadsArray[currentThreadIndex], &threadResult);
+/**
+ * Function that counts the pixels of a circle of any 64 bit wide radius using all the threads of the pool
+ * @note Uses the 128 bit wide boundary kernel, as r^2 and the count no longer fit into 64 bits past r = 2^31
+ * @param r - Radius of the circle
+ * @param n_threads - Max number of threads that can be utilized
+ * @return unsigned __int128 - Number of pixels that were encompassed by the circle's area
+ */
+unsigned __int128 count_pixels_large(int64_t r, int n_threads) {
+    if (r <= 0)
+        return 0;
+    ColumnPool &pool = sharedColumnPool(n_threads);
+    int64_t chunkSize = max(minChunkSize, r / (chunksPerThread * pool.threads()) + 1);
+    unsigned __int128 resultCounter = pool.run(1, r, chunkSize, [r](int64_t firstX, int64_t lastX) {
+        return countColumnsBoundaryWide(r, firstX, lastX);
+    });
+    return resultCounter * 4 + 1;
+}
 
-            // Increments the main result counter with the thread's localized counter (merges the results from the threads)
-            resultCounter += reinterpret_cast<uint64_t>(threadResult);
-        }
+/**
+ * Function that counts the pixels of the circles of many radii in a single sweep over the columns using all the threads of the pool
+ * @note Every chunk of columns is handled for all the radii that reach it. Each radius still walks all of its columns, only the boundary at the start of the chunk is seeded from the one of the previous radius instead of taking a square root
+ * @param radii - Vector of radii (sorted in increasing order for best performance, duplicates are only counted once)
+ * @param n_threads - Max number of threads that can be utilized
+ * @return vector - Number of pixels of each circle (same order as radii, 0 for radii below 1)
+ */
+std::vector<unsigned __int128> count_pixels_batch(const std::vector<int64_t> &radii, int n_threads) {
+    // Works on the sorted distinct positive radii
+    vector<int64_t> sortedRadii;
+    for (auto r : radii)
+        if (r > 0)
+            sortedRadii.push_back(r);
+    sort(sortedRadii.begin(), sortedRadii.end());
+    sortedRadii.erase(unique(sortedRadii.begin(), sortedRadii.end()), sortedRadii.end());
+
+    vector<unsigned __int128> results(radii.size(), 0);
+    if (sortedRadii.empty())
+        return results;
+
+    // Each thread adds into its own row of counters, the rows share one buffer and are a cache line of unused counters apart so that two threads never write to the same line
+    ColumnPool &pool = sharedColumnPool(n_threads);
+    size_t stride = sortedRadii.size() + 64 / sizeof(unsigned __int128);
+    vector<unsigned __int128> threadCounters(pool.threads() * stride, 0);
+    int64_t maxRadius = sortedRadii.back();
+    int64_t chunkSize = max(minChunkSize, maxRadius / (chunksPerThread * pool.threads()) + 1);
+    pool.forEachChunk(1, maxRadius, chunkSize, [&](int threadIndex, int64_t firstX, int64_t lastX) {
+        // Radii smaller than firstX have no pixels in this chunk
+        size_t first = lower_bound(sortedRadii.begin(), sortedRadii.end(), firstX) - sortedRadii.begin();
+        countColumnsBoundarySweep(sortedRadii.data() + first, sortedRadii.size() - first, firstX, lastX,
+                                  threadCounters.data() + threadIndex * stride + first);
+    });
+
+    // Reduces the per thread counters and maps the results back to the order of the passed in radii
+    for (size_t index = 0; index < radii.size(); index++) {
+        if (radii[index] <= 0)
+            continue;
+        size_t slot = lower_bound(sortedRadii.begin(), sortedRadii.end(), radii[index]) - sortedRadii.begin();
+        unsigned __int128 counter = 0;
+        for (int thread = 0; thread < pool.threads(); thread++)
+            counter += threadCounters[thread * stride + slot];
+        results[index] = counter * 4 + 1;
     }
-
-    // Returns 4 times the value of the result counter as there are 4 quadrants when dealing with a grid (and we only solved for one quadrant as the rest are similar)
-    return resultCounter * 4 + 1;
+    return results;
 }
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "calcpi.h"
+#include "pixelKernels.h"
+#include <cstdint>
+#include <vector>
+
+// Extensions of count_pixels() that live outside of calcpi.h so the assignment header stays untouched
+
+/**
+ * Function that counts the pixels like count_pixels() but with the passed in kernel (e.g. countColumnsBruteForceSimd when the brute force results are needed)
+ * @param r - Radius of the circle
+ * @param n_threads - Max number of threads that can be utilized
+ * @param kernel - Function used to count the pixels of each chunk of columns
+ * @return uint64_t - Number of pixels that were encompassed by the circle's area
+ */
+uint64_t count_pixels(int r, int n_threads, ColumnKernel kernel);
+
+/**
+ * Function that counts the pixels like count_pixels() for any radius up to 2^62 with exact 128 bit wide math
+ * @param r - Radius of the circle
+ * @param n_threads - Max number of threads that can be utilized
+ * @return unsigned __int128 - Number of pixels that were encompassed by the circle's area
+ */
+unsigned __int128 count_pixels_large(int64_t r, int n_threads);
+
+/**
+ * Function that computes count_pixels_large() for every radius in one pass over the columns
+ * @param radii - Vector of radii (sorted in increasing order for best performance)
+ * @param n_threads - Max number of threads that can be utilized
+ * @return vector - Number of pixels of each circle (same order as radii)
+ */
+std::vector<unsigned __int128> count_pixels_batch(const std::vector<int64_t> &radii, int n_threads);
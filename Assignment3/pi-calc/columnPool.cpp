@@ -0,0 +1,136 @@
+#include "columnPool.h"
+#include <map>
+#include <memory>
+
+using namespace std;
+
+ColumnPool::ColumnPool(int n_threads) {
+    pthread_mutex_init(&runMutex, nullptr);
+    pthread_mutex_init(&poolMutex, nullptr);
+    pthread_cond_init(&jobReady, nullptr);
+    pthread_cond_init(&jobDone, nullptr);
+
+    // Creates the worker threads (the thread calling run() works as well, so one less is needed)
+    workerThreads.resize(n_threads > 1 ? n_threads - 1 : 0);
+    for (auto &thread : workerThreads)
+        pthread_create(&thread, nullptr, threadWork, (void *) this);
+}
+
+ColumnPool::~ColumnPool() {
+    // Tells all the workers to exit and waits for them to do so
+    pthread_mutex_lock(&poolMutex);
+    shouldStop = true;
+    pthread_cond_broadcast(&jobReady);
+    pthread_mutex_unlock(&poolMutex);
+    for (auto &thread : workerThreads)
+        pthread_join(thread, nullptr);
+
+    pthread_cond_destroy(&jobDone);
+    pthread_cond_destroy(&jobReady);
+    pthread_mutex_destroy(&poolMutex);
+    pthread_mutex_destroy(&runMutex);
+}
+
+/**
+ * Function that will be used by the pool's threads to perform their work
+ * @param input - Pointer to the ColumnPool object that owns the thread
+ */
+void *ColumnPool::threadWork(void *input) {
+    ((ColumnPool *) input)->workerLoop();
+    return nullptr;
+}
+
+/**
+ * Function that waits for runs to start and works on them until the pool is stopped
+ */
+void ColumnPool::workerLoop() {
+    pthread_mutex_lock(&poolMutex);
+    // Index 0 belongs to the thread calling forEachChunk(), and generation 0 means no run has started yet (a worker that starts late still joins the first run)
+    int threadIndex = ++workersStarted;
+    uint64_t seenGeneration = 0;
+    while (true) {
+        while (!shouldStop && generation == seenGeneration)
+            pthread_cond_wait(&jobReady, &poolMutex);
+        if (shouldStop)
+            break;
+        seenGeneration = generation;
+        pthread_mutex_unlock(&poolMutex);
+
+        workOnJob(threadIndex);
+
+        // Wakes up the thread calling forEachChunk() once the last worker is done
+        pthread_mutex_lock(&poolMutex);
+        if (--workersBusy == 0)
+            pthread_cond_signal(&jobDone);
+    }
+    pthread_mutex_unlock(&poolMutex);
+}
+
+/**
+ * Function that keeps claiming chunks of the current run until none are left
+ * @param threadIndex - Index of the calling thread (passed on to the work function)
+ */
+void ColumnPool::workOnJob(int threadIndex) {
+    while (true) {
+        int64_t chunk = nextChunk.fetch_add(1, memory_order_relaxed);
+        if (chunk >= jobChunks)
+            break;
+        int64_t firstX = jobFirstX + chunk * jobChunkSize;
+        int64_t lastX = jobLastX - firstX < jobChunkSize ? jobLastX : firstX + jobChunkSize - 1;
+        (*jobWork)(threadIndex, firstX, lastX);
+    }
+}
+
+unsigned __int128 ColumnPool::run(int64_t firstX, int64_t lastX, int64_t chunkSize, const ChunkCounter &counter) {
+    // Each thread adds into its own counter
+    vector<PaddedCounter> threadCounters(threads());
+    for (auto &threadCounter : threadCounters)
+        threadCounter.value = 0;
+    forEachChunk(firstX, lastX, chunkSize, [&](int threadIndex, int64_t chunkFirstX, int64_t chunkLastX) {
+        threadCounters[threadIndex].value += counter(chunkFirstX, chunkLastX);
+    });
+
+    // Reduces the per thread counters into the final result
+    unsigned __int128 result = 0;
+    for (auto &threadCounter : threadCounters)
+        result += threadCounter.value;
+    return result;
+}
+
+void ColumnPool::forEachChunk(int64_t firstX, int64_t lastX, int64_t chunkSize, const ChunkWork &work) {
+    if (firstX > lastX)
+        return;
+    pthread_mutex_lock(&runMutex);
+
+    // Describes the run and wakes up the workers
+    pthread_mutex_lock(&poolMutex);
+    jobFirstX = firstX;
+    jobLastX = lastX;
+    jobChunkSize = chunkSize < 1 ? 1 : chunkSize;
+    jobChunks = (lastX - firstX) / jobChunkSize + 1;
+    jobWork = &work;
+    nextChunk = 0;
+    workersBusy = int(workerThreads.size());
+    generation++;
+    pthread_cond_broadcast(&jobReady);
+    pthread_mutex_unlock(&poolMutex);
+
+    // Works on the run as well and then waits for the workers to finish
+    workOnJob(0);
+    pthread_mutex_lock(&poolMutex);
+    while (workersBusy != 0)
+        pthread_cond_wait(&jobDone, &poolMutex);
+    pthread_mutex_unlock(&poolMutex);
+    pthread_mutex_unlock(&runMutex);
+}
+
+ColumnPool &sharedColumnPool(int n_threads) {
+    static pthread_mutex_t poolsMutex = PTHREAD_MUTEX_INITIALIZER;
+    static map<int, unique_ptr<ColumnPool>> pools;
+    pthread_mutex_lock(&poolsMutex);
+    auto &pool = pools[n_threads];
+    if (!pool)
+        pool.reset(new ColumnPool(n_threads));
+    pthread_mutex_unlock(&poolsMutex);
+    return *pool;
+}
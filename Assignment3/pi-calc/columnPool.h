@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <pthread.h>
+#include <vector>
+
+/**
+ * Class that owns a persistent pool of threads which split a range of columns between themselves in small chunks
+ * @note Chunks are handed out dynamically through an atomic counter so threads that get cheap columns simply take more chunks
+ */
+class ColumnPool {
+public:
+    // Signature of the function that counts the pixels of the columns firstX..lastX (inclusive)
+    typedef std::function<unsigned __int128(int64_t firstX, int64_t lastX)> ChunkCounter;
+
+    // Signature of the function that works on the columns firstX..lastX (inclusive), threadIndex is in [0, threads())
+    typedef std::function<void(int threadIndex, int64_t firstX, int64_t lastX)> ChunkWork;
+
+    /**
+     * Constructor that spawns n_threads - 1 worker threads (the thread calling run() is the remaining one)
+     * @param n_threads - Number of threads that will work on each run (values below 1 are treated as 1)
+     */
+    explicit ColumnPool(int n_threads);
+
+    /**
+     * Destructor that stops and joins all the worker threads
+     */
+    ~ColumnPool();
+
+    ColumnPool(const ColumnPool &) = delete;
+
+    ColumnPool &operator=(const ColumnPool &) = delete;
+
+    /**
+     * Function that counts the pixels of the columns firstX..lastX using all the threads of the pool (blocks until done, concurrent calls are serialized)
+     * @param firstX - First column to count
+     * @param lastX - Last column to count (inclusive)
+     * @param chunkSize - Number of columns a thread claims at once
+     * @param counter - Function that counts the pixels of a chunk of columns
+     * @return unsigned __int128 - Sum of the counts of all the chunks
+     */
+    unsigned __int128 run(int64_t firstX, int64_t lastX, int64_t chunkSize, const ChunkCounter &counter);
+
+    /**
+     * Function that hands every chunk of the columns firstX..lastX to one of the threads of the pool (blocks until done, concurrent calls are serialized)
+     * @note The work function can keep per thread results indexed by threadIndex, as no two threads ever get the same index during a call
+     * @param firstX - First column
+     * @param lastX - Last column (inclusive)
+     * @param chunkSize - Number of columns a thread claims at once
+     * @param work - Function that is called once per chunk
+     */
+    void forEachChunk(int64_t firstX, int64_t lastX, int64_t chunkSize, const ChunkWork &work);
+
+    /**
+     * Function that returns the number of threads that work on each run (including the calling thread)
+     * @return int - Number of threads
+     */
+    int threads() const { return int(workerThreads.size()) + 1; }
+
+private:
+    // Per thread counter padded to its own cache line so that threads never write to the same line
+    struct alignas(64) PaddedCounter {
+        unsigned __int128 value;
+    };
+
+    std::vector<pthread_t> workerThreads;
+
+    // Mutex that serializes the calls to forEachChunk()
+    pthread_mutex_t runMutex;
+
+    // Mutex and condition variables used to start the workers on a run and to wait for them to be done
+    pthread_mutex_t poolMutex;
+    pthread_cond_t jobReady;
+    pthread_cond_t jobDone;
+
+    // Incremented every time a run starts so that the workers know that there is new work
+    uint64_t generation = 0;
+
+    // Number of workers that have not finished the current run yet
+    int workersBusy = 0;
+
+    // Boolean that will tell the workers to exit
+    bool shouldStop = false;
+
+    // Number of workers that have picked their index into threadCounters
+    int workersStarted = 0;
+
+    // Description of the current run (written before the generation is incremented)
+    int64_t jobFirstX = 0;
+    int64_t jobLastX = 0;
+    int64_t jobChunkSize = 1;
+    int64_t jobChunks = 0;
+    const ChunkWork *jobWork = nullptr;
+
+    // Index of the next unclaimed chunk of the current run
+    std::atomic<int64_t> nextChunk{0};
+
+    static void *threadWork(void *input);
+
+    void workerLoop();
+
+    void workOnJob(int threadIndex);
+};
+
+/**
+ * Function that returns a pool with the requested number of threads, creating it on first use (pools are kept until the program exits)
+ * @param n_threads - Number of threads of the pool
+ * @return ColumnPool - Reference to the shared pool
+ */
+ColumnPool &sharedColumnPool(int n_threads);
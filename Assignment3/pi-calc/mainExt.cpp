@@ -0,0 +1,88 @@
+#include "calcpiExt.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// entry point of the extended modes (other kernels, radii past 100000 and
+// batches of radii), kept apart from main.cpp so the assignment driver stays
+// untouched
+
+void usage() {
+    std::cout << "Usage: ./calcpiExt radius n_threads [kernel]\n"
+              << "       ./calcpiExt --batch n_threads < radii\n"
+              << "   where 0 <= radius <= 1000000000000\n"
+              << "     and 1 <= n_threads <= 256\n"
+              << "     and kernel is one of boundary (default), brute, simd\n"
+              << "   (only the boundary kernel can be used for radius > 100000)\n"
+              << "   --batch reads radii from stdin and prints r,count,pi as CSV\n";
+    exit(-1);
+}
+
+// converts a 128 bit wide count to a decimal string
+static std::string to_string(unsigned __int128 n) {
+    std::string digits;
+    do {
+        digits.insert(digits.begin(), char('0' + int(n % 10)));
+        n /= 10;
+    } while (n);
+    return digits;
+}
+
+// counts the pixels for every radius read from stdin in one sweep and
+// prints the results as CSV
+static int run_batch(int n_threads) {
+    std::vector<int64_t> radii;
+    long long r;
+    while (std::cin >> r) {
+        if (r < 0 || r > 1000000000000LL) usage();
+        radii.push_back(r);
+    }
+    std::vector<unsigned __int128> counts = count_pixels_batch(radii, n_threads);
+    std::cout << "r,count,pi\n" << std::setprecision(18);
+    for (size_t i = 0; i < radii.size(); i++) {
+        long double pi = radii[i] ? (long double) counts[i] / ((long double) radii[i] * radii[i]) : 0;
+        std::cout << radii[i] << "," << to_string(counts[i]) << "," << pi << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc == 3 && std::string(argv[1]) == "--batch") {
+        int n_threads;
+        if (1 != sscanf(argv[2], "%d", &n_threads) || n_threads < 1 || n_threads > 256) usage();
+        return run_batch(n_threads);
+    }
+    long long r;
+    int n_threads;
+    ColumnKernel kernel = countColumnsBoundary;
+    if (argc != 3 && argc != 4) usage();
+    if (argc == 4) {
+        std::string name = argv[3];
+        if (name == "brute") kernel = countColumnsBruteForce;
+        else if (name == "simd") kernel = countColumnsBruteForceSimd;
+        else if (name != "boundary") usage();
+    }
+    if (1 != sscanf(argv[1], "%lld", &r)) usage();
+    if (1 != sscanf(argv[2], "%d", &n_threads)) usage();
+    if (r < 0 || r > 1000000000000LL || n_threads < 1 || n_threads > 256) usage();
+    if (r > 100000 && argc == 4 && kernel != countColumnsBoundary) usage();
+
+    std::cout << "Calculating PI with r=" << r
+              << " and n_threads=" << n_threads << "\n";
+    if (r > 100000) {
+        // radii past the original limit need the 128 bit wide version
+        unsigned __int128 count = count_pixels_large(r, n_threads);
+        long double pi = (long double) count / ((long double) r * r);
+        std::cout << "count: " << to_string(count) << "\n";
+        std::cout << "PI:    " << std::setprecision(18) << pi << "\n";
+        return 0;
+    }
+    uint64_t count = count_pixels(int(r), n_threads, kernel);
+    double pi = count / (double(r) * r);
+    std::cout << "count: " << count << "\n";
+    std::cout << "PI:    " << std::setprecision(15) << pi << "\n";
+    return 0;
+}
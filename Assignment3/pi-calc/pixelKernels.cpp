@@ -0,0 +1,194 @@
+#include "pixelKernels.h"
+#include <immintrin.h>
+#include <cmath>
+
+using namespace std;
+
+int64_t integerSqrt(int64_t n) {
+    // The double result of sqrt() can be off by one for large n so it is corrected with integer math
+    int64_t root = int64_t(sqrt(double(n)));
+    while (root > 0 && root > n / root)
+        root--;
+    while (root + 1 <= n / (root + 1))
+        root++;
+    return root;
+}
+
+uint64_t integerSqrt(unsigned __int128 n) {
+    // Starts from the long double estimate (64 bit mantissa) and corrects it with exact 128 bit wide math
+    auto root = uint64_t(sqrtl((long double) n));
+    while (root > 0 && (unsigned __int128) root * root > n)
+        root--;
+    while ((unsigned __int128) (root + 1) * (root + 1) <= n)
+        root++;
+    return root;
+}
+
+uint64_t countColumnsBruteForce(int64_t r, int64_t firstX, int64_t lastX) {
+    // Initialize a local counter to that will store the result that will be returned
+    uint64_t counter = 0;
+
+    // Stores the r^2 value as a double (retains decimal places)
+    double radiusSquared = double(r) * r;
+
+    // Loop that runs within the passed in column bounds
+    for (double x = double(firstX); x <= double(lastX); x++)
+        // Loop that runs radius + 1 number of times
+        for (double y = 0; y <= r; y++)
+            // Checks to see if (x^2 + y^2) <= radius^2 and increments the local counter if it is
+            if (x * x + y * y <= radiusSquared)
+                counter++;
+    return counter;
+}
+
+/**
+ * Function that counts the pixels of a single column with y in [firstY, r] that are inside the circle
+ * @param r - Radius of the circle
+ * @param limit - r^2 - x^2 of the column
+ * @param firstY - First row to test
+ * @return uint64_t - Number of pixels inside the circle
+ */
+static uint64_t countColumnTail(int64_t r, int64_t limit, int64_t firstY) {
+    uint64_t counter = 0;
+    for (int64_t y = firstY; y <= r; y++)
+        if (y * y <= limit)
+            counter++;
+    return counter;
+}
+
+/**
+ * AVX2 version of the brute force kernel, 2 vectors of 4 64 bit wide lanes per iteration
+ */
+__attribute__((target("avx2")))
+static uint64_t countColumnsAvx2(int64_t r, int64_t firstX, int64_t lastX) {
+    uint64_t counter = 0;
+    const __m256i step = _mm256_set1_epi64x(8);
+    for (int64_t x = firstX; x <= lastX; x++) {
+        int64_t limit = r * r - x * x;
+        const __m256i limitVector = _mm256_set1_epi64x(limit);
+        __m256i low = _mm256_setr_epi64x(0, 1, 2, 3);
+        __m256i high = _mm256_setr_epi64x(4, 5, 6, 7);
+        // Subtracting the all ones compare mask counts the pixels outside the circle in each lane
+        __m256i outside = _mm256_setzero_si256();
+        int64_t y = 0;
+        for (; y + 7 <= r; y += 8) {
+            // y < 2^32 so the 32 x 32 bit multiply gives the exact 64 bit square
+            outside = _mm256_sub_epi64(outside, _mm256_cmpgt_epi64(_mm256_mul_epu32(low, low), limitVector));
+            outside = _mm256_sub_epi64(outside, _mm256_cmpgt_epi64(_mm256_mul_epu32(high, high), limitVector));
+            low = _mm256_add_epi64(low, step);
+            high = _mm256_add_epi64(high, step);
+        }
+        alignas(32) int64_t lanes[4];
+        _mm256_store_si256((__m256i *) lanes, outside);
+        counter += uint64_t(y - (lanes[0] + lanes[1] + lanes[2] + lanes[3]));
+        counter += countColumnTail(r, limit, y);
+    }
+    return counter;
+}
+
+/**
+ * AVX-512 version of the brute force kernel, 2 vectors of 8 64 bit wide lanes per iteration counted with mask popcounts
+ */
+__attribute__((target("avx512f,popcnt")))
+static uint64_t countColumnsAvx512(int64_t r, int64_t firstX, int64_t lastX) {
+    uint64_t counter = 0;
+    const __m512i step = _mm512_set1_epi64(16);
+    for (int64_t x = firstX; x <= lastX; x++) {
+        int64_t limit = r * r - x * x;
+        const __m512i limitVector = _mm512_set1_epi64(limit);
+        __m512i low = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+        __m512i high = _mm512_setr_epi64(8, 9, 10, 11, 12, 13, 14, 15);
+        int64_t y = 0;
+        for (; y + 15 <= r; y += 16) {
+            __mmask8 lowInside = _mm512_cmple_epi64_mask(_mm512_maskz_mul_epu32(0xFF, low, low), limitVector);
+            __mmask8 highInside = _mm512_cmple_epi64_mask(_mm512_maskz_mul_epu32(0xFF, high, high), limitVector);
+            counter += uint64_t(_mm_popcnt_u32(lowInside | (unsigned(highInside) << 8)));
+            low = _mm512_add_epi64(low, step);
+            high = _mm512_add_epi64(high, step);
+        }
+        counter += countColumnTail(r, limit, y);
+    }
+    return counter;
+}
+
+uint64_t countColumnsBruteForceSimd(int64_t r, int64_t firstX, int64_t lastX) {
+    static const bool hasAvx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt");
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx512)
+        return countColumnsAvx512(r, firstX, lastX);
+    if (hasAvx2)
+        return countColumnsAvx2(r, firstX, lastX);
+    return countColumnsBruteForce(r, firstX, lastX);
+}
+
+uint64_t countColumnsBoundary(int64_t r, int64_t firstX, int64_t lastX) {
+    if (firstX > lastX)
+        return 0;
+    int64_t radiusSquared = r * r;
+
+    // Highest y inside the circle for the first column
+    int64_t y = integerSqrt(radiusSquared - firstX * firstX);
+
+    uint64_t counter = 0;
+    for (int64_t x = firstX; x <= lastX; x++) {
+        // Steps the boundary down until the pixel is inside the circle again (at most r steps in total over all columns)
+        int64_t limit = radiusSquared - x * x;
+        while (y * y > limit)
+            y--;
+        // Pixels 0..y of the column are inside the circle
+        counter += uint64_t(y + 1);
+    }
+    return counter;
+}
+
+/**
+ * Function that counts the pixels of the columns firstX..lastX given the boundary of the first column
+ * @param r - Radius of the circle
+ * @param firstX - First column to count
+ * @param lastX - Last column to count (inclusive, at most r)
+ * @param y - Highest y inside the circle for the first column
+ * @return unsigned __int128 - Number of pixels of the columns that are inside the circle
+ */
+static unsigned __int128 countFromBoundary(int64_t r, int64_t firstX, int64_t lastX, uint64_t y) {
+    // r^2 - x^2 for the current column
+    unsigned __int128 limit = (unsigned __int128) r * r - (unsigned __int128) firstX * firstX;
+
+    unsigned __int128 counter = 0;
+    for (int64_t x = firstX; x <= lastX; x++) {
+        // Steps the boundary down until the pixel is inside the circle again (at most r steps in total over all columns)
+        while ((unsigned __int128) y * y > limit)
+            y--;
+        counter += y + 1;
+        // Moves the limit to the next column since (x + 1)^2 = x^2 + 2x + 1
+        limit -= 2 * (unsigned __int128) x + 1;
+    }
+    return counter;
+}
+
+unsigned __int128 countColumnsBoundaryWide(int64_t r, int64_t firstX, int64_t lastX) {
+    if (firstX > lastX)
+        return 0;
+    return countFromBoundary(r, firstX, lastX, integerSqrt((unsigned __int128) r * r - (unsigned __int128) firstX * firstX));
+}
+
+void countColumnsBoundarySweep(const int64_t *radii, size_t count, int64_t firstX, int64_t lastX,
+                               unsigned __int128 *counters) {
+    // Boundary of the previous (smaller) radius at firstX, which is a lower bound for the boundary of the next one
+    uint64_t previousY = 0;
+    for (size_t i = 0; i < count; i++) {
+        int64_t r = radii[i];
+        if (r < firstX)
+            continue;
+
+        // Steps up from the previous radius's boundary when the radii are close, and takes the square root otherwise
+        unsigned __int128 limit = (unsigned __int128) r * r - (unsigned __int128) firstX * firstX;
+        uint64_t y = previousY;
+        for (int steps = 0; steps < 64 && (unsigned __int128) (y + 1) * (y + 1) <= limit; steps++)
+            y++;
+        if ((unsigned __int128) (y + 1) * (y + 1) <= limit)
+            y = integerSqrt(limit);
+        previousY = y;
+
+        counters[i] += countFromBoundary(r, firstX, lastX < r ? lastX : r, y);
+    }
+}
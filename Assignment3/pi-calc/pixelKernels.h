@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Signature shared by all the column counting kernels, they count the pixels (x, y) with firstX <= x <= lastX, 0 <= y <= r and x^2 + y^2 <= r^2
+typedef uint64_t (*ColumnKernel)(int64_t r, int64_t firstX, int64_t lastX);
+
+/**
+ * Kernel that tests every pixel of every column (the reference O(r^2) algorithm from pi-calc)
+ * @param r - Radius of the circle
+ * @param firstX - First column to count
+ * @param lastX - Last column to count (inclusive)
+ * @return uint64_t - Number of pixels of the columns that are inside the circle
+ */
+uint64_t countColumnsBruteForce(int64_t r, int64_t firstX, int64_t lastX);
+
+/**
+ * Kernel that tests every pixel of every column like countColumnsBruteForce() but with integer squares, many pixels per instruction
+ * @note Uses AVX-512 (16 pixels per iteration) or AVX2 (8 pixels per iteration) depending on what the CPU supports (chosen at runtime), and countColumnsBruteForce() otherwise
+ * @param r - Radius of the circle (r^2 must fit into 63 bits)
+ * @param firstX - First column to count
+ * @param lastX - Last column to count (inclusive)
+ * @return uint64_t - Number of pixels of the columns that are inside the circle
+ */
+uint64_t countColumnsBruteForceSimd(int64_t r, int64_t firstX, int64_t lastX);
+
+/**
+ * Kernel that finds the highest pixel of each column inside the circle in O(1) amortized time using integer math only
+ * @note The first column uses an exact integer square root and every following column steps the boundary down (midpoint circle style) since it only decreases as x grows
+ * @param r - Radius of the circle (r^2 must fit into 63 bits)
+ * @param firstX - First column to count
+ * @param lastX - Last column to count (inclusive)
+ * @return uint64_t - Number of pixels of the columns that are inside the circle
+ */
+uint64_t countColumnsBoundary(int64_t r, int64_t firstX, int64_t lastX);
+
+/**
+ * Kernel that works like countColumnsBoundary() but with 128 bit wide squares and counters so that any 64 bit wide radius can be used
+ * @param r - Radius of the circle
+ * @param firstX - First column to count
+ * @param lastX - Last column to count (inclusive)
+ * @return unsigned __int128 - Number of pixels of the columns that are inside the circle
+ */
+unsigned __int128 countColumnsBoundaryWide(int64_t r, int64_t firstX, int64_t lastX);
+
+/**
+ * Kernel that counts the pixels of the columns firstX..lastX for many radii at once
+ * @note The boundary of each radius at firstX is found by stepping up from the boundary of the previous radius, so dense sweeps of radii rarely need a square root
+ * @param radii - Pointer to the radii, sorted in increasing order
+ * @param count - Number of radii
+ * @param firstX - First column to count
+ * @param lastX - Last column to count (inclusive, columns past a radius are skipped for that radius)
+ * @param counters - Pointer to count counters, the number of pixels of each radius is added to the counter in the same position
+ */
+void countColumnsBoundarySweep(const int64_t *radii, size_t count, int64_t firstX, int64_t lastX,
+                               unsigned __int128 *counters);
+
+/**
+ * Function that computes floor(sqrt(n)) exactly for 128 bit wide numbers
+ * @param n - Number to compute the integer square root of
+ * @return uint64_t - Largest 64 bit wide integer whose square is less than or equal to n
+ */
+uint64_t integerSqrt(unsigned __int128 n);
+
+/**
+ * Function that computes floor(sqrt(n)) exactly
+ * @param n - Non negative number to compute the integer square root of
+ * @return int64_t - Largest 64 bit wide integer whose square is less than or equal to n
+ */
+int64_t integerSqrt(int64_t n);
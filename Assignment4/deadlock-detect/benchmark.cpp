@@ -0,0 +1,252 @@
+#include "common.h"
+#include "deadlock_ext.h"
+#include "online_detector.h"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Kinds of graphs the generator can produce
+static const vector<string> graphKinds{"random", "chain", "fanin", "late"};
+
+// Detection modes that are benchmarked
+static const vector<string> detectionModes{"incremental", "search", "scc", "online"};
+
+/**
+ * Function that appends an edge line to the generated text
+ * @param text - Text to append to
+ * @param process - Number of the process
+ * @param request - True for a request (process waits on resource), false for an assignment
+ * @param resource - Number of the resource
+ */
+static void addEdge(string &text, uint64_t process, bool request, uint64_t resource) {
+    text += 'p';
+    text += to_string(process);
+    text += request ? " -> r" : " <- r";
+    text += to_string(resource);
+    text += '\n';
+}
+
+/**
+ * Function that generates a graph in the input format of the detector
+ * @note random: uniform random edges (cycles show up early). chain: a few long chains p0 -> r0 <- p1 -> r1 ... interleaved with each other, the last edge closes one chain into a cycle. fanin: many processes request a few resources held by a few processes, the last edge makes one holder wait on another. late: random edges that respect a hidden order, the last edge goes against it (no cycle before the very last edge)
+ * @param kind - Kind of graph (one of graphKinds)
+ * @param edges - Number of edges to generate (at least 2)
+ * @param seed - Seed of the random number generator
+ * @return string - One edge per line
+ */
+static string generateGraph(const string &kind, uint64_t edges, uint64_t seed) {
+    mt19937_64 random(seed);
+    string text;
+    text.reserve(edges * 16);
+    uint64_t nodes = max<uint64_t>(edges / 2, 2);
+
+    if (kind == "random") {
+        for (uint64_t edge = 0; edge < edges; edge++)
+            addEdge(text, random() % nodes, random() & 1, random() % nodes);
+    } else if (kind == "chain") {
+        // Chain c uses processes and resources c, c + chains, c + 2 * chains, ... and the chains take turns adding an edge
+        uint64_t chains = 16;
+        uint64_t perChain = (edges - 1) / chains;
+        for (uint64_t step = 0; step < perChain; step++)
+            for (uint64_t chain = 0; chain < chains; chain++) {
+                uint64_t link = step / 2 * chains + chain;
+                if (step % 2 == 0)
+                    addEdge(text, link, true, link);
+                else
+                    addEdge(text, link + chains, false, link);
+            }
+        for (uint64_t edge = perChain * chains; edge + 1 < edges; edge++)
+            addEdge(text, nodes + edge, true, nodes + edge);
+        // Closes chain 0 (p0 -> r0 <- p16 -> ... ) into a cycle, its end is a resource when it got an odd number of edges
+        uint64_t lastLink = (perChain - 1) / 2 * chains;
+        if (perChain % 2 == 1)
+            addEdge(text, 0, false, lastLink);
+        else
+            addEdge(text, lastLink + chains, true, 0);
+    } else if (kind == "fanin") {
+        // Resource r is held by process r (r < hot), every other process requests one of the hot resources
+        uint64_t hot = max<uint64_t>(edges / 1000, 2);
+        for (uint64_t resource = 0; resource < hot && resource + 1 < edges; resource++)
+            addEdge(text, resource, false, resource);
+        for (uint64_t edge = hot; edge + 2 < edges; edge++)
+            addEdge(text, hot + edge, true, random() % hot);
+        // Holder 0 waits on resource 1 while holder 1 waits on resource 0
+        addEdge(text, 0, true, 1);
+        addEdge(text, 1, true, 0);
+    } else {
+        // Every process and resource gets a rank, processes only wait on higher ranked resources and resources on higher ranked processes
+        vector<uint64_t> processRank(nodes), resourceRank(nodes);
+        for (auto &rank : processRank)
+            rank = random();
+        for (auto &rank : resourceRank)
+            rank = random();
+        for (uint64_t edge = 0; edge + 2 < edges; edge++) {
+            uint64_t process = random() % nodes, resource = random() % nodes;
+            addEdge(text, process, processRank[process] < resourceRank[resource], resource);
+        }
+        // An edge that respects the order followed by the opposite edge between the same pair closes a cycle on the last one
+        uint64_t process = random() % nodes, resource = random() % nodes;
+        bool request = processRank[process] < resourceRank[resource];
+        addEdge(text, process, request, resource);
+        addEdge(text, process, !request, resource);
+    }
+    return text;
+}
+
+/**
+ * Function that splits the generated text into validated edge lines (the same work main.cpp does on its input)
+ * @param text - Generated text
+ * @return vector - One string per edge
+ */
+static vector<string> parseGraph(const string &text) {
+    vector<string> lines;
+    string_view rest = text;
+    while (!rest.empty()) {
+        auto newline = (const char *) memchr(rest.data(), '\n', rest.size());
+        size_t length = newline ? newline - rest.data() : rest.size();
+        string_view line = rest.substr(0, length), tokens = line;
+        rest.remove_prefix(min(rest.size(), length + 1));
+        string_view process = next_token(tokens), activity = next_token(tokens), resource = next_token(tokens);
+        if (process.empty() || (activity != "->" && activity != "<-") || !is_alnum(process) || !is_alnum(resource)) {
+            cerr << "Generated an invalid line: " << line << "\n";
+            exit(1);
+        }
+        lines.emplace_back(line);
+    }
+    return lines;
+}
+
+/**
+ * Function that runs one mode on one graph and prints its CSV row without the peak RSS (runs in its own process so that the parent can add the peak RSS of this run only)
+ * @param kind - Kind of graph
+ * @param edges - Number of edges
+ * @param mode - Detection mode
+ * @param nThreads - Number of threads of the scc mode
+ */
+static void runOnce(const string &kind, uint64_t edges, const string &mode, int nThreads) {
+    string text = generateGraph(kind, edges, 457);
+    auto start = chrono::steady_clock::now();
+    vector<string> lines = parseGraph(text);
+    double parseSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    string().swap(text);
+
+    // Runs the detection, edgesSeen is the number of edges the mode had to look at
+    start = chrono::steady_clock::now();
+    long long edgeIndex = -1, procs = 0;
+    uint64_t edgesSeen = lines.size();
+    if (mode == "scc") {
+        procs = cyclic_processes(lines, nThreads).size();
+    } else if (mode == "online") {
+        DeadlockDetector detector(false);
+        for (auto &line : lines) {
+            string_view tokens = line;
+            string_view process = next_token(tokens), activity = next_token(tokens), resource = next_token(tokens);
+            DeadlockReport result = activity == "->" ? detector.add_request(process, resource)
+                                             : detector.add_assignment(process, resource);
+            if (result.edge_index != -1 && edgeIndex == -1) {
+                edgeIndex = result.edge_index;
+                procs = (result.cycle.size() + 1) / 2;
+            }
+        }
+    } else {
+        DeadlockReport result = detect_deadlock_report(lines, mode == "search" ? DetectionMode::BinarySearch : DetectionMode::Incremental);
+        edgeIndex = result.edge_index;
+        procs = result.dl_procs.size();
+        if (mode == "incremental" && edgeIndex != -1)
+            edgesSeen = edgeIndex + 1;
+    }
+    double detectSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    printf("%s,%llu,%s,%.6f,%.6f,%.1f,%lld,%lld", kind.c_str(), (unsigned long long) edges, mode.c_str(),
+           parseSeconds, detectSeconds, detectSeconds * 1e9 / edgesSeen, edgeIndex, procs);
+    fflush(stdout);
+}
+
+static void usage(const char *pname) {
+    cout << "Usage: " << pname << " [maxEdges] [minEdges] [nThreads]\n"
+         << "    runs every detection mode on every kind of generated graph with 10^k edges,\n"
+         << "    minEdges <= 10^k <= maxEdges (defaults 10^4 and 10^6), scc uses nThreads\n"
+         << "    threads (default 4)\n"
+         << "   " << pname << " --generate kind edges [seed]\n"
+         << "    prints a generated graph (kind is random, chain, fanin or late)\n";
+    exit(-1);
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2 && string(argv[1]) == "--generate") {
+        if (argc < 4 || argc > 5)
+            usage(argv[0]);
+        string kind = argv[2];
+        uint64_t edges = strtoull(argv[3], nullptr, 10);
+        uint64_t seed = argc == 5 ? strtoull(argv[4], nullptr, 10) : 457;
+        bool known = false;
+        for (auto &name : graphKinds)
+            known |= name == kind;
+        if (!known || edges < 2)
+            usage(argv[0]);
+        string text = generateGraph(kind, edges, seed);
+        fwrite(text.data(), 1, text.size(), stdout);
+        return 0;
+    }
+
+    uint64_t maxEdges = argc >= 2 ? strtoull(argv[1], nullptr, 10) : 1000000;
+    uint64_t minEdges = argc >= 3 ? strtoull(argv[2], nullptr, 10) : 10000;
+    int nThreads = argc >= 4 ? atoi(argv[3]) : 4;
+    if (argc > 4 || minEdges < 2 || maxEdges < minEdges || nThreads < 1)
+        usage(argv[0]);
+
+    // The number of edges per row is the size of the graph, ns_per_edge divides the detection time by the edges the mode had to look at
+    cout << "kind,edges,mode,parse_seconds,detect_seconds,ns_per_edge,peak_rss_mb,edge_index,procs" << endl;
+    cout << fixed << setprecision(1);
+    int failures = 0;
+    for (uint64_t edges = minEdges; edges <= maxEdges; edges *= 10)
+        for (auto &kind : graphKinds) {
+            for (auto &mode : detectionModes) {
+                // Each run gets its own process, the child's row is read through a pipe
+                int pipeFds[2];
+                if (pipe(pipeFds) != 0) {
+                    perror("pipe");
+                    return 1;
+                }
+                pid_t child = fork();
+                if (child == 0) {
+                    dup2(pipeFds[1], 1);
+                    close(pipeFds[0]);
+                    close(pipeFds[1]);
+                    runOnce(kind, edges, mode, nThreads);
+                    _exit(0);
+                }
+                close(pipeFds[1]);
+                string row;
+                char buffer[256];
+                ssize_t length;
+                while ((length = read(pipeFds[0], buffer, sizeof(buffer))) > 0)
+                    row.append(buffer, length);
+                close(pipeFds[0]);
+                int status;
+                struct rusage usage;
+                wait4(child, &status, 0, &usage);
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                    cerr << kind << " " << edges << " " << mode << " failed\n";
+                    failures++;
+                    continue;
+                }
+
+                // Inserts the peak RSS in front of the answer (ru_maxrss is in KiB)
+                size_t answer = row.rfind(',', row.rfind(',') - 1);
+                cout << row.substr(0, answer + 1) << usage.ru_maxrss / 1024.0 << "," << row.substr(answer + 1) << endl;
+            }
+        }
+    return failures ? 1 : 0;
+}
@@ -5,43 +5,110 @@
 #include "common.h"
 
 #include <cctype>
+#include <cerrno>
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using VS = std::vector<std::string>;
 
 // split string p_line into vector of strings (words)
 // the delimiters are 1 or more whitespaces
 VS split(const std::string &p_line) {
-    auto line = p_line + " ";
     VS res;
-    bool in_str = false;
-    std::string curr_word = "";
-    for (auto c : line) {
-        if (isspace(c)) {
-            if (in_str)
-                res.push_back(curr_word);
-            in_str = false;
-            curr_word = "";
-        } else {
-            curr_word.push_back(c);
-            in_str = true;
-        }
+    std::string_view rest = p_line;
+    while (1) {
+        auto tok = next_token(rest);
+        if (tok.empty())
+            break;
+        res.emplace_back(tok);
     }
     return res;
 }
 
+std::string_view next_token(std::string_view &str) {
+    size_t start = 0;
+    while (start < str.size() && isspace((unsigned char) str[start]))
+        start++;
+    size_t stop = start;
+    while (stop < str.size() && !isspace((unsigned char) str[stop]))
+        stop++;
+    auto tok = str.substr(start, stop - start);
+    str.remove_prefix(stop);
+    return tok;
+}
+
 std::string stdin_readline() {
-    std::string result;
+    static LineReader reader(0);
+    std::string_view line;
+    if (!reader.next(line))
+        return "";
+    return std::string(line);
+}
+
+LineReader::LineReader(int p_fd) : fd(p_fd) {
+    // map regular files, starting at the current offset of the descriptor
+    struct stat st;
+    off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && offset >= 0 && st.st_size > offset) {
+        void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            mapped = (const char *) addr;
+            mapped_size = st.st_size;
+            pos = offset;
+            return;
+        }
+    }
+    buffer.resize(1 << 20);
+}
+
+LineReader::~LineReader() {
+    if (mapped)
+        munmap((void *) mapped, mapped_size);
+}
+
+bool LineReader::next(std::string_view &line) {
+    if (mapped) {
+        if (pos >= mapped_size)
+            return false;
+        auto start = mapped + pos;
+        auto nl = (const char *) memchr(start, '\n', mapped_size - pos);
+        size_t len = nl ? nl - start + 1 : mapped_size - pos;
+        line = std::string_view(start, len);
+        pos += len;
+        return true;
+    }
     while (1) {
-        int c = fgetc(stdin);
-        if (c == -1)
-            break;
-        result.push_back(c);
-        if (c == '\n')
-            break;
+        auto start = buffer.data() + pos;
+        auto nl = (const char *) memchr(start, '\n', end - pos);
+        if (nl || (eof && pos < end)) {
+            size_t len = nl ? nl - start + 1 : end - pos;
+            line = std::string_view(start, len);
+            pos += len;
+            return true;
+        }
+        if (eof)
+            return false;
+
+        // move the partial line to the front (growing the buffer if the
+        // line fills all of it) and read the next block behind it
+        memmove(buffer.data(), start, end - pos);
+        end -= pos;
+        pos = 0;
+        if (end == buffer.size())
+            buffer.resize(buffer.size() * 2);
+        ssize_t n = read(fd, buffer.data() + end, buffer.size() - end);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            eof = true;
+        else
+            end += n;
     }
-    return result;
 }
 
 std::string join(const VS &toks, const std::string &sep) {
@@ -56,7 +123,7 @@ std::string join(const VS &toks, const std::string &sep) {
 
 std::string simplify(const std::string &str) { return join(split(str)); }
 
-bool is_alnum(const std::string &str) {
+bool is_alnum(std::string_view str) {
     for (int c : str)
         if (!isalnum(c))
             return false;
@@ -0,0 +1,118 @@
+#include "csr_graph.h"
+#include <algorithm>
+
+using namespace std;
+
+int CsrGraph::addNode() {
+    outgoing.deltaHead.push_back(-1);
+    incoming.deltaHead.push_back(-1);
+    return nodes++;
+}
+
+void CsrGraph::addEdge(int from, int to) {
+    int edge = int(logSources.size());
+    logSources.push_back(from);
+    logTargets.push_back(to);
+    outgoing.deltaNext.push_back(outgoing.deltaHead[from]);
+    outgoing.deltaHead[from] = edge;
+    incoming.deltaNext.push_back(incoming.deltaHead[to]);
+    incoming.deltaHead[to] = edge;
+
+    // Keeps the deltas small compared to the compressed part so that most walks stay in the contiguous arrays
+    if (int(outgoing.deltaNext.size()) > max(64, edgeCount() / 4))
+        rebuild();
+}
+
+bool CsrGraph::removeEdge(int from, int to) {
+    // A recent edge is overwritten in the log, which hides it from the delta lists of both of its nodes
+    bool removed = false;
+    for (int edge = outgoing.deltaHead[from]; edge != -1; edge = outgoing.deltaNext[edge - outgoing.compressedEdges])
+        if (logTargets[edge] == to) {
+            logSources[edge] = logTargets[edge] = -1;
+            removed = true;
+            break;
+        }
+
+    // A compressed edge is overwritten in the rows of both of its nodes
+    if (!removed && outgoing.removeCompressed(from, to)) {
+        incoming.removeCompressed(to, from);
+        removed = true;
+    }
+    if (!removed)
+        return false;
+
+    // Drops the removed edges once they take up a quarter of the log
+    removedEdges++;
+    if (removedEdges > max(64, int(logSources.size()) / 4))
+        rebuild();
+    return true;
+}
+
+/**
+ * Function that overwrites one copy of neighbor in the compressed row of node with -1
+ * @param node - Id of the node whose row is searched
+ * @param neighbor - Id of the neighbor to remove
+ * @return bool - True if the neighbor was found
+ */
+bool CsrGraph::Rows::removeCompressed(int node, int neighbor) {
+    if (node >= int(offsets.size()) - 1)
+        return false;
+    for (int index = offsets[node]; index < offsets[node + 1]; index++)
+        if (neighbors[index] == neighbor) {
+            neighbors[index] = -1;
+            return true;
+        }
+    return false;
+}
+
+/**
+ * Function that compacts the edge log (keeping only the edges that were not removed) and rebuilds the rows of both directions from it
+ */
+void CsrGraph::rebuild() {
+    // The compressed part of the log may still hold removed edges, so those edges are taken from the outgoing rows instead
+    vector<int> sources, targets;
+    sources.reserve(edgeCount());
+    targets.reserve(edgeCount());
+    for (int node = 0; node + 1 < int(outgoing.offsets.size()); node++)
+        for (int index = outgoing.offsets[node]; index < outgoing.offsets[node + 1]; index++)
+            if (outgoing.neighbors[index] != -1) {
+                sources.push_back(node);
+                targets.push_back(outgoing.neighbors[index]);
+            }
+    for (int edge = outgoing.compressedEdges; edge < int(logSources.size()); edge++)
+        if (logSources[edge] != -1) {
+            sources.push_back(logSources[edge]);
+            targets.push_back(logTargets[edge]);
+        }
+    logSources.swap(sources);
+    logTargets.swap(targets);
+    removedEdges = 0;
+
+    outgoing.rebuild(nodes, logSources, logTargets);
+    incoming.rebuild(nodes, logTargets, logSources);
+}
+
+/**
+ * Function that rebuilds the offset and neighbor arrays from the whole edge log and empties the delta lists
+ * @param nodes - Number of nodes in the graph
+ * @param logKeys - Node every edge of the log is grouped under
+ * @param logNeighbors - Node at the other end of every edge of the log
+ */
+void CsrGraph::Rows::rebuild(int nodes, const vector<int> &logKeys, const vector<int> &logNeighbors) {
+    // Counts the edges of every node and turns the counts into offsets
+    offsets.assign(nodes + 1, 0);
+    for (int key : logKeys)
+        offsets[key + 1]++;
+    for (int node = 0; node < nodes; node++)
+        offsets[node + 1] += offsets[node];
+
+    // Places every edge behind the ones of the same node that were added before it
+    neighbors.resize(logNeighbors.size());
+    vector<int> nextSlot(offsets.begin(), offsets.end() - 1);
+    for (size_t edge = 0; edge < logKeys.size(); edge++)
+        neighbors[nextSlot[logKeys[edge]]++] = logNeighbors[edge];
+
+    compressedEdges = int(logKeys.size());
+    fill(deltaHead.begin(), deltaHead.end(), -1);
+    deltaNext.clear();
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+
+/**
+ * Class that stores the edges of a growing directed graph in compressed sparse row form (both the outgoing and the incoming edges of every node) so that walking the edges of a node reads contiguous memory
+ * @note New edges are appended to an edge log and linked into small per node delta lists, once the deltas hold more than a quarter of the edges the whole log is rebuilt into the offset and neighbor arrays (amortized O(1) per edge). Removed edges are overwritten with -1 where they are stored and dropped by the next rebuild
+ */
+class CsrGraph {
+public:
+    /**
+     * Function that adds a new node with no edges
+     * @return int - Id of the new node (ids are consecutive, starting with 0)
+     */
+    int addNode();
+
+    /**
+     * Function that adds the edge from -> to
+     * @param from - Id of the node the edge starts at
+     * @param to - Id of the node the edge ends at
+     */
+    void addEdge(int from, int to);
+
+    /**
+     * Function that removes one copy of the edge from -> to
+     * @param from - Id of the node the edge starts at
+     * @param to - Id of the node the edge ends at
+     * @return bool - True if the edge was found and removed
+     */
+    bool removeEdge(int from, int to);
+
+    /**
+     * Function that calls visit(next) for the end of every edge that starts at node
+     * @param node - Id of the node
+     * @param visit - Function called with the end of each edge, returning true stops the walk
+     * @return bool - True if visit() stopped the walk
+     */
+    template<typename Visit>
+    bool forEachOut(int node, Visit visit) const { return outgoing.forEach(node, logTargets, visit); }
+
+    /**
+     * Function that calls visit(previous) for the start of every edge that ends at node
+     * @param node - Id of the node
+     * @param visit - Function called with the start of each edge, returning true stops the walk
+     * @return bool - True if visit() stopped the walk
+     */
+    template<typename Visit>
+    bool forEachIn(int node, Visit visit) const { return incoming.forEach(node, logSources, visit); }
+
+    /**
+     * Function that returns the number of nodes in the graph
+     * @return int - Number of nodes
+     */
+    int size() const { return nodes; }
+
+    /**
+     * Function that returns the number of edges in the graph
+     * @return int - Number of edges
+     */
+    int edgeCount() const { return int(logSources.size()) - removedEdges; }
+
+private:
+    // Custom data struct that stores the edges of every node in one direction
+    struct Rows {
+        // The compressed neighbors of node v are at positions offsets[v] .. offsets[v + 1] - 1 of neighbors
+        std::vector<int> offsets{0};
+        std::vector<int> neighbors;
+
+        // Number of edges of the log that are in the compressed arrays
+        int compressedEdges = 0;
+
+        // Log position of the newest edge of every node added since the last rebuild (-1 if none), deltaNext links each one to the next older one
+        std::vector<int> deltaHead;
+        std::vector<int> deltaNext;
+
+        template<typename Visit>
+        bool forEach(int node, const std::vector<int> &logNeighbors, Visit &visit) const {
+            if (node < int(offsets.size()) - 1)
+                for (int index = offsets[node]; index < offsets[node + 1]; index++)
+                    if (neighbors[index] != -1 && visit(neighbors[index]))
+                        return true;
+            for (int edge = deltaHead[node]; edge != -1; edge = deltaNext[edge - compressedEdges])
+                if (logNeighbors[edge] != -1 && visit(logNeighbors[edge]))
+                    return true;
+            return false;
+        }
+
+        bool removeCompressed(int node, int neighbor);
+
+        void rebuild(int nodes, const std::vector<int> &logKeys, const std::vector<int> &logNeighbors);
+    };
+
+    int nodes = 0;
+
+    // Edge log, every edge that was compressed by the last rebuild followed by the ones added since then (in the order they were added)
+    std::vector<int> logSources;
+    std::vector<int> logTargets;
+
+    // Number of edges of the log that were removed since the last rebuild
+    int removedEdges = 0;
+
+    // Edges grouped by their start and by their end
+    Rows outgoing;
+    Rows incoming;
+
+    void rebuild();
+};
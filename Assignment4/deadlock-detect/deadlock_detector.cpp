@@ -1,105 +1,166 @@
-#include "deadlock_detector.h"
-#include "common.h"
+#include "deadlock_ext.h"
+#include "dynamic_topo_order.h"
+#include "multi_instance.h"
+#include "node_table.h"
+#include "parallel_scc.h"
+#include "prefix_graph.h"
 
 using namespace std;
 
-// Class that will be used to generate a graph that will be topologically sorted to find cycles in a single instance per resource type system
-class FastGraph {
-public:
-    vector<vector<int>> adjacencyList;
-    vector<int> outDegree;
-};
+/**
+ * Function that adds the edges one by one to a graph that keeps a dynamic topological order and stops at the first edge that closes a cycle
+ * @note Each insertion only touches the nodes between the edge's endpoints instead of re-sorting the whole graph
+ * @param edges - Edge strings to process
+ * @return result - DeadlockReport struct where dl_procs are all processes current in deadlock, cycle is the cycle closed by edge_index (taken from the search that rejected the edge) and blocked_procs are the processes waiting on it
+ */
+static DeadlockReport detectIncremental(const vector<string> &edges) {
+    // Initialize a object that will store the results (sets the default value to indicate no cycles were detected)
+    DeadlockReport result;
+    result.edge_index = -1;
+
+    // Creates a new graph object that will store the edges (pointing from the waiting node to the node it waits on) in topological order
+    DynamicTopoOrder graph;
+    NodeTable nodes;
+
+    // Loops through all the edges provided and populates the graph until an edge closes a cycle
+    for (int counter = 0; counter < int(edges.size()); counter++) {
+        pair<int, int> edge = nodes.parseEdge(edges[counter]);
+
+        // Adds a node to the graph for every new id
+        while (graph.size() < nodes.size())
+            graph.addNode();
+        if (graph.addEdge(edge.first, edge.second))
+            continue;
+
+        // The edge closes a cycle, every process that can reach the edge's start is either on the cycle or waiting on it
+        result.edge_index = counter;
+        vector<int> reaching = graph.nodesReaching(edge.first);
+        nodes.addProcesses(reaching, result);
+        nodes.addCycle(graph.lastCycle(), reaching, result);
+        break;
+    }
+    return result;
+}
 
 /**
- * Function that uses the provided edges vector to create a graph and checks for deadlocks via topological sort after each edge is inserted
+ * Function that parses every edge once and then searches for the shortest prefix of the edges that contains a cycle
+ * @note Adding edges can only create cycles, so whether a prefix is cyclic is monotone in its length. The search doubles the prefix length until it becomes cyclic and then binary searches the last doubling step, each probe is a single O(V + E) check of the same compressed graph
+ * @param edges - Edge strings to process
+ * @return result - DeadlockReport struct where dl_procs are all processes current in deadlock, edge_index is the edge responsible for the deadlock, cycle is the cycle it closed and blocked_procs are the processes waiting on it
+ */
+static DeadlockReport detectBinarySearch(const vector<string> &edges) {
+    // Initialize a object that will store the results (sets the default value to indicate no cycles were detected)
+    DeadlockReport result;
+    result.edge_index = -1;
+
+    // Converts every edge into a pair of integer ids
+    NodeTable nodes;
+    vector<pair<int, int>> parsedEdges;
+    parsedEdges.reserve(edges.size());
+    for (auto &edge : edges)
+        parsedEdges.push_back(nodes.parseEdge(edge));
+    PrefixGraph graph(nodes.size(), parsedEdges);
+
+    // Doubles the prefix length until it contains a cycle (acyclic is the longest prefix known to have no cycle), 64 bits wide since the doubling can go past the largest int before it stops
+    int64_t total = graph.edgeCount();
+    int64_t acyclic = 0, cyclic = 1;
+    while (cyclic <= total && !graph.hasCycle(int(cyclic))) {
+        acyclic = cyclic;
+        cyclic *= 2;
+    }
+    if (cyclic > total) {
+        if (acyclic == total || !graph.hasCycle(int(total)))
+            return result;
+        cyclic = total;
+    }
+
+    // Narrows the range down until the cyclic prefix is exactly one edge longer than the acyclic one
+    while (cyclic - acyclic > 1) {
+        int64_t middle = acyclic + (cyclic - acyclic) / 2;
+        if (graph.hasCycle(int(middle)))
+            cyclic = middle;
+        else
+            acyclic = middle;
+    }
+
+    // The last edge of the shortest cyclic prefix is the one that caused the deadlock, the nodes left over by its check are the ones in deadlock
+    graph.hasCycle(int(cyclic));
+    result.edge_index = int(cyclic - 1);
+    vector<int> blocked = graph.blockedNodes();
+    nodes.addProcesses(blocked, result);
+    nodes.addCycle(graph.cycleThroughLastEdge(int(cyclic)), blocked, result);
+    return result;
+}
+
+/**
+ * Function that uses the provided edges vector to create a graph and checks for deadlocks after each edge is inserted
  * @note Implements code from deadlock-detect (https://gitlab.com/cpsc457/public/deadlock-detect)
  * @param edges - Pointer to a string vector composed of a string for the process and resource alongside a string indicating whether a request or assignment is occurring
  * @return result - Result struct where dl_procs are all processes current in deadlock and edge_index is the edge responsible for the deadlock
  */
 Result detect_deadlock(const std::vector<std::string> &edges) {
-    // Initialize a object that will store the results (what edge caused a deadlock and which processes are in deadlock)
-    Result result;
-
-    // Sets the default value of the result to indicate no cycles were detected
-    result.edge_index = -1;
-
-    // Creates a new graph object that will store the adjacency list based on the passed in input alongside each node's out degree
-    FastGraph graph;
+    return detectIncremental(edges);
+}
 
-    // Initialize a converter object whose job would be to take in the passed in process and resource strings and convert them to unique integers instead
-    Word2Int stringConverter;
+/**
+ * Function that works like detect_deadlock() but lets the caller pick the algorithm and also reports the cycle
+ * @param edges - Pointer to a string vector composed of a string for the process and resource alongside a string indicating whether a request or assignment is occurring
+ * @param mode - Algorithm to find the first deadlocking edge with
+ * @return result - DeadlockReport struct where dl_procs are all processes current in deadlock, edge_index is the edge responsible for the deadlock, cycle is the cycle it closed and blocked_procs are the processes waiting on it
+ */
+DeadlockReport detect_deadlock_report(const std::vector<std::string> &edges, DetectionMode mode) {
+    if (mode == DetectionMode::BinarySearch)
+        return detectBinarySearch(edges);
+    return detectIncremental(edges);
+}
 
-    // Initialize an unordered map that will store the unique integer ids for all the processes and resources while also storing their original string
-    unordered_map<int, string> conversionRecord;
+/**
+ * Function that finds the processes on a cycle of the whole graph, checking the graph with several threads
+ * @param edges - Pointer to a string vector composed of a string for the process and resource alongside a string indicating whether a request or assignment is occurring
+ * @param n_threads - Number of threads to use
+ * @return vector - Names of the processes that are on a cycle
+ */
+std::vector<std::string> cyclic_processes(const std::vector<std::string> &edges, int n_threads) {
+    // Converts every edge into a pair of integer ids
+    NodeTable nodes;
+    vector<pair<int, int>> parsedEdges;
+    parsedEdges.reserve(edges.size());
+    for (auto &edge : edges)
+        parsedEdges.push_back(nodes.parseEdge(edge));
+
+    // Collects the processes among the nodes that lie on a cycle
+    vector<char> onCycle = nodesOnCycles(nodes.size(), parsedEdges, n_threads);
+    vector<int> cyclicNodes;
+    for (int node = 0; node < nodes.size(); node++)
+        if (onCycle[node])
+            cyclicNodes.push_back(node);
+    Result result;
+    nodes.addProcesses(cyclicNodes, result);
+    return result.dl_procs;
+}
 
-    // Loops through all the edges provided and populates the graph (adjacency list and out degree vector)
-    for (int counter = 0; counter < int(edges.size()); counter++) {
-        // Vector to store parts of the current string being parsed (in the form of process, operator, resource)
-        vector<string> cleanedStringParts = split(simplify(edges[counter]));
-
-        // Stores the current string's process, operator and resource node data
-        int process = stringConverter.get("P" + cleanedStringParts[0]);
-        conversionRecord[process] = "P" + cleanedStringParts[0];
-        string activity = cleanedStringParts[1];
-        int resource = stringConverter.get("R" + cleanedStringParts[2]);
-        conversionRecord[resource] = "R" + cleanedStringParts[2];
-
-        // Checks to see if 2 or 1 new blank entries need to be added to the graph adjacency list and out degree vector (based on how many unique nodes we will be handling this iteration)
-        if (int(graph.adjacencyList.size()) - process == -1 || int(graph.adjacencyList.size()) - resource == -1) {
-            graph.adjacencyList.emplace_back();
-            graph.adjacencyList.emplace_back();
-            graph.outDegree.push_back(0);
-            graph.outDegree.push_back(0);
-        } else if (int(graph.adjacencyList.size()) - process == 0 || int(graph.adjacencyList.size()) - resource == 0) {
-            graph.adjacencyList.emplace_back();
-            graph.outDegree.push_back(0);
-        }
-
-        // Populates the adjacency list and out degree vector appropriately based on whether the current string is an request or assignment operation
-        if (activity == "->") {
-            graph.adjacencyList[resource].push_back(process);
-            graph.outDegree[process]++;
-        } else if (activity == "<-") {
-            graph.adjacencyList[process].push_back(resource);
-            graph.outDegree[resource]++;
-        }
-
-        // Stores a local copy of the graph's out degree vector so that it can be modified safely for cycle detection
-        vector<int> outDegreeTemp = graph.outDegree;
-
-        // Creates and populates a vector that will store all nodes with an out degree value of 0
-        vector<int> outDegreeZeroNodes;
-        for (int innerCounter = 0; innerCounter < int(outDegreeTemp.size()); innerCounter++)
-            if (outDegreeTemp[innerCounter] == 0)
-                outDegreeZeroNodes.push_back(innerCounter);
-
-        // Loops through all nodes that had an out degree value of zero
-        while (!outDegreeZeroNodes.empty()) {
-            // Stores and pops the last element from the vector of nodes with out degree zero
-            int zeroNode = outDegreeZeroNodes.back();
-            outDegreeZeroNodes.pop_back();
-
-            // Decrements the out degree value of any nodes pointing to the current node (that was popped) and pops them out as well if they are now at out degree zero
-            for (int currentNode : graph.adjacencyList[zeroNode]) {
-                outDegreeTemp[currentNode]--;
-                if (outDegreeTemp[currentNode] == 0)
-                    outDegreeZeroNodes.push_back(currentNode);
-            }
-        }
-
-        // Loops through the shrunk graph and populates the result object if any deadlocked processes are found
-        for (int innerCounter = 0; innerCounter <= int(outDegreeTemp.size()); innerCounter++) {
-            if (outDegreeTemp[innerCounter] > 0 && conversionRecord[innerCounter].substr(0, 1) == "P") {
-                result.edge_index = counter;
-                result.dl_procs.push_back(conversionRecord[innerCounter].substr(1));
-            }
-        }
-
-        // If any deadlocked processes were found then stops populating the graph further
-        if (!result.dl_procs.empty())
-            break;
+/**
+ * Function that finds the deadlocked processes of a system whose resources can have several instances
+ * @param lines - Pointer to a string vector composed of requests ("p -> r n"), allocations ("p <- r n") and capacities ("r = n")
+ * @return result - Result struct where dl_procs are the deadlocked processes and edge_index is the last line if there are any
+ */
+Result detect_multi_deadlock(const std::vector<std::string> &lines) {
+    MultiInstanceState state;
+    for (auto &line : lines) {
+        // Splits the line into its words, the count is optional for requests and allocations
+        string_view rest = line;
+        string_view first = next_token(rest), activity = next_token(rest), second = next_token(rest);
+        string_view count = next_token(rest);
+        if (activity == "=")
+            state.setCapacity(first, stoll(string(second)));
+        else if (activity == "->")
+            state.addRequest(first, second, count.empty() ? 1 : stoll(string(count)));
+        else
+            state.addAllocation(first, second, count.empty() ? 1 : stoll(string(count)));
     }
 
-    // Returns the result back to the calling code
+    Result result;
+    result.dl_procs = state.deadlockedProcesses();
+    result.edge_index = result.dl_procs.empty() ? -1 : int(lines.size()) - 1;
     return result;
 }
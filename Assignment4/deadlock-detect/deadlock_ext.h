@@ -0,0 +1,46 @@
+#pragma once
+
+#include "deadlock_detector.h"
+#include <string>
+#include <vector>
+
+// extensions of detect_deadlock() that live outside of deadlock_detector.h so
+// the assignment header stays untouched
+
+// Result of detect_deadlock() together with the cycle behind the deadlock
+struct DeadlockReport : Result {
+    // names on the cycle closed by edge_index, starting with a process and
+    // alternating with the resources, each one waiting on the next one (the
+    // last one waits on the first one)
+    std::vector<std::string> cycle;
+    // processes of dl_procs that are not on the cycle but wait on it
+    std::vector<std::string> blocked_procs;
+};
+
+// algorithms detect_deadlock_report() can use to find the first deadlocking edge
+enum class DetectionMode {
+    // keeps a dynamic topological order while the edges are added one by one
+    Incremental,
+    // builds the whole graph once, then finds the first cyclic prefix with
+    // exponential + binary search, one linear time check per probe
+    BinarySearch,
+};
+
+// same as detect_deadlock() with the chosen algorithm, also reports the cycle
+// and the processes blocked behind it
+DeadlockReport detect_deadlock_report(const std::vector<std::string> &edges,
+                                      DetectionMode mode = DetectionMode::Incremental);
+
+// finds every process that is on a cycle of the graph made of all the edges
+// (the graph is checked as a whole using n_threads threads, processes that
+// only wait on a cycle are not included), in the order they first appear
+std::vector<std::string> cyclic_processes(const std::vector<std::string> &edges, int n_threads);
+
+// finds the deadlocked processes of a system whose resources can have several
+// instances, the lines describe the current state as a whole:
+//   "p -> r n"  p waits for n more instances of r (n defaults to 1)
+//   "p <- r n"  p holds n instances of r (n defaults to 1)
+//   "r = n"     r has n instances (resources that are not listed have 1)
+// edge_index is the last line if there is a deadlock (-1 otherwise), throws
+// std::runtime_error if a resource has more instances held than it has
+Result detect_multi_deadlock(const std::vector<std::string> &lines);
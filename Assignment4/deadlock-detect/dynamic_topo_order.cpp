@@ -0,0 +1,147 @@
+#include "dynamic_topo_order.h"
+#include <algorithm>
+
+using namespace std;
+
+int DynamicTopoOrder::addNode() {
+    int node = int(order.size());
+    edges.addNode();
+    order.push_back(node);
+    visited.push_back(0);
+    parent.push_back(-1);
+    return node;
+}
+
+/**
+ * Function that visits every node reachable from start whose position is at most upperBound (iterative DFS, remembering how every node was reached)
+ * @param start - Node to start at
+ * @param upperBound - Largest position that is part of the affected region
+ * @param target - Node whose discovery means that a cycle was found
+ * @return bool - True if target was reached
+ */
+bool DynamicTopoOrder::searchForward(int start, int upperBound, int target) {
+    stack.assign(1, start);
+    visited[start] = 1;
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        forwardNodes.push_back(node);
+        bool found = edges.forEachOut(node, [&](int next) {
+            if (next == target) {
+                parent[next] = node;
+                return true;
+            }
+            if (!visited[next] && order[next] <= upperBound) {
+                visited[next] = 1;
+                parent[next] = node;
+                stack.push_back(next);
+            }
+            return false;
+        });
+        if (found)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * Function that visits every node that reaches start whose position is above lowerBound (iterative DFS over the incoming edges)
+ * @param start - Node to start at
+ * @param lowerBound - Smallest position that is part of the affected region
+ */
+void DynamicTopoOrder::searchBackward(int start, int lowerBound) {
+    stack.assign(1, start);
+    visited[start] = 1;
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        backwardNodes.push_back(node);
+        edges.forEachIn(node, [&](int previous) {
+            if (!visited[previous] && order[previous] > lowerBound) {
+                visited[previous] = 1;
+                stack.push_back(previous);
+            }
+            return false;
+        });
+    }
+}
+
+/**
+ * Function that moves the nodes found by the backward search in front of the nodes found by the forward search, reusing the positions they already occupied
+ */
+void DynamicTopoOrder::reorder() {
+    auto byOrder = [this](int a, int b) { return order[a] < order[b]; };
+    sort(forwardNodes.begin(), forwardNodes.end(), byOrder);
+    sort(backwardNodes.begin(), backwardNodes.end(), byOrder);
+
+    // Collects the positions of all the affected nodes in increasing order
+    vector<int> positions;
+    positions.reserve(forwardNodes.size() + backwardNodes.size());
+    for (int node : backwardNodes)
+        positions.push_back(order[node]);
+    for (int node : forwardNodes)
+        positions.push_back(order[node]);
+    sort(positions.begin(), positions.end());
+
+    // Hands the positions out to the backward nodes first and then to the forward nodes (each group keeps its relative order)
+    size_t next = 0;
+    for (int node : backwardNodes)
+        order[node] = positions[next++];
+    for (int node : forwardNodes)
+        order[node] = positions[next++];
+}
+
+bool DynamicTopoOrder::addEdge(int from, int to) {
+    int lowerBound = order[to];
+    int upperBound = order[from];
+
+    // Nothing has to move when the edge already agrees with the order
+    if (lowerBound > upperBound) {
+        edges.addEdge(from, to);
+        return true;
+    }
+
+    // Searches the affected region, a path from to back to from means that the edge would close a cycle
+    forwardNodes.clear();
+    backwardNodes.clear();
+    bool closesCycle = from == to || searchForward(to, upperBound, from);
+    if (closesCycle) {
+        // Follows the search's parents back from the edge's start to its end, which gives the path to -> ... -> from
+        cycle.assign(1, from);
+        if (from != to) {
+            for (int node = parent[from]; node != to; node = parent[node])
+                cycle.push_back(node);
+            cycle.push_back(to);
+            reverse(cycle.begin() + 1, cycle.end());
+        }
+    } else {
+        searchBackward(from, lowerBound);
+        reorder();
+        edges.addEdge(from, to);
+    }
+
+    // Clears the marks of every node that was visited
+    for (int node : forwardNodes)
+        visited[node] = 0;
+    for (int node : backwardNodes)
+        visited[node] = 0;
+    for (int node : stack)
+        visited[node] = 0;
+    return !closesCycle;
+}
+
+vector<int> DynamicTopoOrder::nodesReaching(int node) const {
+    vector<char> seen(order.size(), 0);
+    vector<int> found{node};
+    seen[node] = 1;
+    for (size_t index = 0; index < found.size(); index++)
+        edges.forEachIn(found[index], [&](int previous) {
+            if (!seen[previous]) {
+                seen[previous] = 1;
+                found.push_back(previous);
+            }
+            return false;
+        });
+    sort(found.begin(), found.end());
+    return found;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "csr_graph.h"
+#include <vector>
+
+/**
+ * Class that keeps a directed acyclic graph together with a topological order of its nodes while edges are being added
+ * @note Implements the dynamic topological sort of Pearce and Kelly ("A Dynamic Topological Sort Algorithm for Directed Acyclic Graphs", 2006), inserting an edge only visits the nodes whose order lies between the two endpoints
+ */
+class DynamicTopoOrder {
+public:
+    /**
+     * Function that adds a new node with no edges (it is placed at the end of the order)
+     * @return int - Id of the new node (ids are consecutive, starting with 0)
+     */
+    int addNode();
+
+    /**
+     * Function that adds the edge from -> to unless it would create a cycle
+     * @param from - Id of the node the edge starts at
+     * @param to - Id of the node the edge ends at
+     * @return bool - True if the edge was added, false if to can already reach from (the edge is not added in that case)
+     */
+    bool addEdge(int from, int to);
+
+    /**
+     * Function that removes one copy of the edge from -> to (the order stays valid since removing an edge cannot create a cycle)
+     * @param from - Id of the node the edge starts at
+     * @param to - Id of the node the edge ends at
+     * @return bool - True if the edge was found and removed
+     */
+    bool removeEdge(int from, int to) { return edges.removeEdge(from, to); }
+
+    /**
+     * Function that finds every node that can reach the passed in node (the node itself included)
+     * @param node - Id of the node
+     * @return vector - Ids of the nodes that can reach node, in increasing order
+     */
+    std::vector<int> nodesReaching(int node) const;
+
+    /**
+     * Function that returns the cycle found by the last call to addEdge() that returned false, rebuilt from the search that found it (no extra graph walk)
+     * @return vector - Ids of the nodes on the cycle, starting with the rejected edge's start and then its end, each node waiting on the next one (the last one waits on the first)
+     */
+    const std::vector<int> &lastCycle() const { return cycle; }
+
+    /**
+     * Function that returns the number of nodes in the graph
+     * @return int - Number of nodes
+     */
+    int size() const { return int(order.size()); }
+
+private:
+    // Outgoing and incoming edges of every node
+    CsrGraph edges;
+
+    // Position of every node in the topological order (every edge goes from a lower to a higher position)
+    std::vector<int> order;
+
+    // Marks of the nodes visited by the current insertion (always cleared before addEdge() returns)
+    std::vector<char> visited;
+
+    // Node the forward search came from when it first reached every node (only valid for the nodes of the last search)
+    std::vector<int> parent;
+
+    // Cycle found by the last rejected edge
+    std::vector<int> cycle;
+
+    // Nodes found by the forward and backward searches of the current insertion
+    std::vector<int> forwardNodes;
+    std::vector<int> backwardNodes;
+
+    // Stack shared by the searches (kept around to avoid reallocating it for every edge)
+    std::vector<int> stack;
+
+    bool searchForward(int start, int upperBound, int target);
+
+    void searchBackward(int start, int lowerBound);
+
+    void reorder();
+};
@@ -0,0 +1,74 @@
+#include "intern_table.h"
+
+using namespace std;
+
+/**
+ * Function that hashes a name (64 bit FNV-1a)
+ * @param name - Name to hash
+ * @return uint64_t - Hash of the name
+ */
+static uint64_t hashName(string_view name) {
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : name) {
+        hash ^= uint8_t(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+/**
+ * Function that doubles the number of slots and puts every id back into the table
+ */
+void InternTable::grow() {
+    slots.assign(slots.empty() ? 64 : slots.size() * 2, -1);
+    size_t mask = slots.size() - 1;
+    for (int id = 0; id < size(); id++) {
+        size_t slot = hashes[id] & mask;
+        while (slots[slot] != -1)
+            slot = (slot + 1) & mask;
+        slots[slot] = id;
+    }
+}
+
+/**
+ * Function that probes the slots until either the name or an empty slot is found
+ * @param name - Name to look for
+ * @param hash - Hash of the name
+ * @return size_t - Slot that holds the name's id, or the empty slot the name would go into
+ */
+size_t InternTable::probe(string_view name, uint64_t hash) const {
+    size_t mask = slots.size() - 1;
+    size_t slot = hash & mask;
+    while (slots[slot] != -1) {
+        int id = slots[slot];
+        if (hashes[id] == hash && this->name(id) == name)
+            break;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+int InternTable::get(string_view name) {
+    // Keeps the table at most half full so that probe sequences stay short
+    if (size_t(size()) * 2 >= slots.size())
+        grow();
+
+    uint64_t hash = hashName(name);
+    size_t slot = probe(name, hash);
+    if (slots[slot] != -1)
+        return slots[slot];
+
+    // The name is new, copies it into the arena and gives it the next id
+    int id = size();
+    arena.insert(arena.end(), name.begin(), name.end());
+    nameStart.push_back(uint32_t(arena.size()));
+    hashes.push_back(hash);
+    slots[slot] = id;
+    return id;
+}
+
+int InternTable::find(string_view name) const {
+    if (slots.empty())
+        return -1;
+    return slots[probe(name, hashName(name))];
+}
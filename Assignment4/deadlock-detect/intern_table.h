@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/**
+ * Class that turns names into unique consecutive integer ids (like Word2Int) without allocating a string per name
+ * @note The characters of every name are copied once into a single arena and the table is an open addressing hash table (linear probing) that only stores ids and hashes, so looking up a name that was already seen never allocates
+ */
+class InternTable {
+public:
+    /**
+     * Function that returns the id of the passed in name, giving it the next free id if it has not been seen before
+     * @param name - Name to look up (does not have to outlive the call)
+     * @return int - Id of the name (ids start at 0)
+     */
+    int get(std::string_view name);
+
+    /**
+     * Function that returns the id of the passed in name without giving it one if it has not been seen before
+     * @param name - Name to look up
+     * @return int - Id of the name, or -1 if it was never passed to get()
+     */
+    int find(std::string_view name) const;
+
+    /**
+     * Function that returns the name an id was given to
+     * @param id - Id returned by get()
+     * @return string_view - Name of the id (only valid until the next call to get())
+     */
+    std::string_view name(int id) const {
+        return std::string_view(arena.data() + nameStart[id], nameStart[id + 1] - nameStart[id]);
+    }
+
+    /**
+     * Function that returns the number of different names seen so far
+     * @return int - Number of ids handed out
+     */
+    int size() const { return int(nameStart.size()) - 1; }
+
+private:
+    // Characters of all the names back to back, the name of id i is at positions nameStart[i] .. nameStart[i + 1] - 1
+    std::vector<char> arena;
+    std::vector<uint32_t> nameStart{0};
+
+    // Hash of every name (indexed by id, lets probing skip most names without comparing characters)
+    std::vector<uint64_t> hashes;
+
+    // Slots of the hash table, each one holds an id or -1 when empty (the size is always a power of two)
+    std::vector<int> slots;
+
+    void grow();
+
+    size_t probe(std::string_view name, uint64_t hash) const;
+};
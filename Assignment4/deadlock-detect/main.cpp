@@ -20,30 +20,31 @@ static void run_graph() {
     std::cout << "Reading in lines from stdin...\n";
     VS all_lines;
     int line_no = 0;
-    while (1) {
-        // read in the next line and quit loop on EOF
-        auto line = stdin_readline();
-        if (line.size() == 0)
-            break;
+    LineReader reader(0);
+    std::string_view line;
+    while (reader.next(line)) {
         line_no++;
 
         // get rid of trailing \n
         if (line.size() && line.back() == '\n')
-            line.pop_back();
+            line.remove_suffix(1);
 
         // parse input line, skip empty lines
-        auto toks = split(line);
-        if (toks.size() == 0)
+        std::string_view rest = line, toks[4];
+        int ntoks = 0;
+        while (ntoks < 4 && !(toks[ntoks] = next_token(rest)).empty())
+            ntoks++;
+        if (ntoks == 0)
             continue;
 
         // validate line
-        if (toks.size() != 3 || (toks[1] != "->" && toks[1] != "<-") || !is_alnum(toks[0])
+        if (ntoks != 3 || (toks[1] != "->" && toks[1] != "<-") || !is_alnum(toks[0])
             || !is_alnum(toks[2])) {
             std::cout << "Syntax error on line " << line_no << ": " << line << "\n";
             exit(-1);
         }
 
-        all_lines.push_back(line);
+        all_lines.emplace_back(line);
     }
 
     std::cout << "Running detect_deadlock()...\n";
@@ -0,0 +1,219 @@
+#include "common.h"
+#include "deadlock_ext.h"
+#include "online_detector.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+using VS = std::vector<std::string>;
+
+// entry point of the extended modes (other algorithms, the cycle behind the
+// deadlock, online events and resources with several instances), kept apart
+// from main.cpp so the assignment driver stays untouched
+
+// reads stdin line by line and hands every non-empty line to handle(), with
+// up to max_tokens of its tokens (one more than a valid line has, so extra
+// tokens show up), a line that handle() rejects is a syntax error
+template <typename Handler>
+static void read_lines(int max_tokens, Handler handle) {
+    assert(max_tokens <= 8);
+    int line_no = 0;
+    LineReader reader(0);
+    std::string_view line;
+    while (reader.next(line)) {
+        line_no++;
+
+        // get rid of trailing \n
+        if (line.size() && line.back() == '\n')
+            line.remove_suffix(1);
+
+        // parse input line, skip empty lines
+        std::string_view rest = line, toks[8];
+        int ntoks = 0;
+        while (ntoks < max_tokens && !(toks[ntoks] = next_token(rest)).empty())
+            ntoks++;
+        if (ntoks == 0)
+            continue;
+
+        if (!handle(line_no, line, toks, ntoks)) {
+            std::cout << "Syntax error on line " << line_no << ": " << line << "\n";
+            exit(-1);
+        }
+    }
+}
+
+static void run_graph(const std::string &mode, int n_threads) {
+    std::cout << "Reading in lines from stdin...\n";
+    VS all_lines;
+    read_lines(4, [&](int, std::string_view line, const std::string_view *toks, int ntoks) {
+        // validate line
+        if (ntoks != 3 || (toks[1] != "->" && toks[1] != "<-") || !is_alnum(toks[0])
+            || !is_alnum(toks[2]))
+            return false;
+        all_lines.emplace_back(line);
+        return true;
+    });
+
+    if (mode == "scc") {
+        std::cout << "Running cyclic_processes(n_threads=" << n_threads << ")...\n";
+        Timer timer;
+        VS procs = cyclic_processes(all_lines, n_threads);
+        std::cout << "\n"
+                  << "cycle_procs: [" << join(procs, ",") << "]\n"
+                  << "real time  : " << std::fixed << std::setprecision(4) << timer.elapsed()
+                  << "s\n\n";
+        return;
+    }
+
+    std::cout << "Running detect_deadlock()...\n";
+    Timer timer;
+    DeadlockReport res = detect_deadlock_report(
+        all_lines, mode == "search" ? DetectionMode::BinarySearch : DetectionMode::Incremental);
+    std::cout << "\n"
+              << "edge_index : " << res.edge_index << "\n"
+              << "dl_procs   : [" << join(res.dl_procs, ",") << "]\n"
+              << "cycle      : [" << join(res.cycle, ",") << "]\n"
+              << "blocked    : [" << join(res.blocked_procs, ",") << "]\n"
+              << "real time  : " << std::fixed << std::setprecision(4) << timer.elapsed()
+              << "s\n\n";
+}
+
+static void run_online(bool report_blocked) {
+    std::cout << "Reading in events from stdin...\n";
+    DeadlockDetector detector(report_blocked);
+    int deadlocks = 0, unknown = 0;
+    double busy = 0;
+    Timer timer;
+    read_lines(4, [&](int line_no, std::string_view, const std::string_view *toks, int ntoks) {
+        // validate line ("-" removes the edge between the process and the resource)
+        if (ntoks != 3 || (toks[1] != "->" && toks[1] != "<-" && toks[1] != "-")
+            || !is_alnum(toks[0]) || !is_alnum(toks[2]))
+            return false;
+
+        // process the event, only the detector itself is timed
+        timer.reset();
+        DeadlockReport res;
+        res.edge_index = -1;
+        if (toks[1] == "-")
+            unknown += !detector.remove_edge(toks[0], toks[2]);
+        else if (toks[1] == "->")
+            res = detector.add_request(toks[0], toks[2]);
+        else
+            res = detector.add_assignment(toks[0], toks[2]);
+        busy += timer.elapsed();
+
+        // report deadlocks right away
+        if (res.edge_index != -1) {
+            deadlocks++;
+            std::cout << "line " << line_no << ": deadlock, cycle: [" << join(res.cycle, ",") << "]";
+            if (report_blocked)
+                std::cout << ", blocked: [" << join(res.blocked_procs, ",") << "]";
+            std::cout << std::endl;
+        }
+        return true;
+    });
+
+    int events = detector.events();
+    std::cout << "\n"
+              << "events     : " << events << "\n"
+              << "deadlocks  : " << deadlocks << "\n"
+              << "bad removes: " << unknown << "\n"
+              << "real time  : " << std::fixed << std::setprecision(4) << busy << "s\n"
+              << "per event  : " << std::setprecision(3) << (events ? busy / events * 1e6 : 0)
+              << "us\n\n";
+}
+
+// checks for a positive instance count that fits into an int
+static bool is_count(std::string_view str) {
+    if (str.empty() || str.size() > 9 || str.find_first_not_of("0123456789") != str.npos)
+        return false;
+    return str.find_first_not_of('0') != str.npos;
+}
+
+static void run_multi() {
+    std::cout << "Reading in lines from stdin...\n";
+    VS all_lines;
+    read_lines(5, [&](int, std::string_view line, const std::string_view *toks, int ntoks) {
+        // validate line ("p -> r n" and "p <- r n" with an optional count, "r = n")
+        bool ok;
+        if (ntoks == 3 && toks[1] == "=")
+            ok = is_alnum(toks[0]) && is_count(toks[2]);
+        else
+            ok = (ntoks == 3 || (ntoks == 4 && is_count(toks[3])))
+                 && (toks[1] == "->" || toks[1] == "<-") && is_alnum(toks[0])
+                 && is_alnum(toks[2]);
+        if (ok)
+            all_lines.emplace_back(line);
+        return ok;
+    });
+
+    std::cout << "Running detect_multi_deadlock()...\n";
+    Timer timer;
+    Result res;
+    try {
+        res = detect_multi_deadlock(all_lines);
+    } catch (const std::runtime_error &e) {
+        std::cout << "Invalid state: " << e.what() << "\n";
+        exit(-1);
+    }
+    std::cout << "\n"
+              << "edge_index : " << res.edge_index << "\n"
+              << "dl_procs   : [" << join(res.dl_procs, ",") << "]\n"
+              << "real time  : " << std::fixed << std::setprecision(4) << timer.elapsed()
+              << "s\n\n";
+}
+
+static int usage(const std::string &pname) {
+    std::cout << "Usage:\n"
+              << "    " << pname << " [incremental|search|scc [n_threads]|online [cycle]|multi] < input\n"
+              << "        - to process input from stdin\n"
+              << "        - incremental (default) keeps a topological order while adding edges\n"
+              << "        - search binary searches the edge count that first creates a cycle\n"
+              << "        - scc lists the processes on a cycle of the whole graph, using\n"
+              << "          n_threads threads (default 1)\n"
+              << "        - online treats every line as an event and reports deadlocks as\n"
+              << "          they happen, \"p - r\" removes the edge between p and r\n"
+              << "          (cycle only reports the cycles, not the processes blocked on them)\n"
+              << "        - multi reads the current state of resources with several instances,\n"
+              << "          \"p -> r n\" / \"p <- r n\" wait for / hold n instances (default 1),\n"
+              << "          \"r = n\" gives r n instances (default 1)\n";
+    exit(-1);
+}
+
+static int cppmain(const VS &args) {
+    if (args.size() > 3)
+        usage(args[0]);
+    std::string mode = args.size() >= 2 ? args[1] : "incremental";
+    if (mode != "incremental" && mode != "search" && mode != "scc" && mode != "online"
+        && mode != "multi")
+        usage(args[0]);
+    int n_threads = 1;
+    bool report_blocked = true;
+    if (args.size() == 3 && mode == "online") {
+        if (args[2] != "cycle")
+            usage(args[0]);
+        report_blocked = false;
+    } else if (args.size() == 3) {
+        n_threads = atoi(args[2].c_str());
+        if (mode != "scc" || n_threads < 1 || n_threads > 256)
+            usage(args[0]);
+    }
+    if (mode == "online")
+        run_online(report_blocked);
+    else if (mode == "multi")
+        run_multi();
+    else
+        run_graph(mode, n_threads);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    return cppmain({argv + 0, argv + argc});
+}
@@ -0,0 +1,107 @@
+#include "multi_instance.h"
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Function that returns the id of a resource, making room for its capacity if it is new
+ * @param name - Name of the resource
+ * @return int - Id of the resource
+ */
+int MultiInstanceState::resource(string_view name) {
+    int id = resources.get(name);
+    if (id == int(capacity.size()))
+        capacity.push_back(-1);
+    return id;
+}
+
+void MultiInstanceState::setCapacity(string_view resourceName, int64_t instances) {
+    capacity[resource(resourceName)] = instances;
+}
+
+void MultiInstanceState::addRequest(string_view process, string_view resourceName, int64_t instances) {
+    int processId = processes.get(process);
+    requests.push_back({processId, resource(resourceName), instances});
+}
+
+void MultiInstanceState::addAllocation(string_view process, string_view resourceName, int64_t instances) {
+    int processId = processes.get(process);
+    allocations.push_back({processId, resource(resourceName), instances});
+}
+
+vector<string> MultiInstanceState::deadlockedProcesses() const {
+    size_t processCount = processes.size(), resourceCount = resources.size();
+
+    // Builds the request and allocation matrices (one row per process) and the vector of available instances
+    vector<int32_t> request(processCount * resourceCount, 0), allocation(processCount * resourceCount, 0);
+    vector<int64_t> available(resourceCount);
+    for (size_t id = 0; id < resourceCount; id++) {
+        available[id] = capacity[id] == -1 ? 1 : capacity[id];
+        if (available[id] < 0 || available[id] > numeric_limits<int32_t>::max())
+            throw runtime_error("resource " + string(resources.name(id)) + " has an invalid number of instances");
+    }
+    auto addCount = [](int32_t &count, int64_t instances) {
+        int64_t total = count + instances;
+        if (instances < 0 || total > numeric_limits<int32_t>::max())
+            throw runtime_error("instance count out of range");
+        count = int32_t(total);
+    };
+    for (auto &entry : requests)
+        addCount(request[entry.process * resourceCount + entry.resource], entry.instances);
+    for (auto &entry : allocations) {
+        addCount(allocation[entry.process * resourceCount + entry.resource], entry.instances);
+        available[entry.resource] -= entry.instances;
+    }
+    vector<int32_t> work(resourceCount);
+    for (size_t id = 0; id < resourceCount; id++) {
+        if (available[id] < 0)
+            throw runtime_error("resource " + string(resources.name(id)) + " has more instances held than it has");
+        work[id] = int32_t(available[id]);
+    }
+
+    // A process that holds nothing cannot be part of a deadlock, it starts out finished
+    vector<uint64_t> finished((processCount + 63) / 64, 0);
+    for (size_t process = 0; process < processCount; process++) {
+        const int32_t *held = &allocation[process * resourceCount];
+        int32_t any = 0;
+        for (size_t id = 0; id < resourceCount; id++)
+            any |= held[id];
+        if (!any)
+            finished[process / 64] |= uint64_t(1) << (process % 64);
+    }
+
+    // Lets every process whose requests can be met finish and release what it holds, until a whole pass finishes none
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (size_t word = 0; word < finished.size(); word++) {
+            uint64_t waiting = ~finished[word];
+            if (word == finished.size() - 1 && processCount % 64)
+                waiting &= (uint64_t(1) << (processCount % 64)) - 1;
+            while (waiting) {
+                size_t process = word * 64 + __builtin_ctzll(waiting);
+                waiting &= waiting - 1;
+
+                // Checks every resource without branching so that the loop is vectorized
+                const int32_t *wanted = &request[process * resourceCount];
+                bool fits = true;
+                for (size_t id = 0; id < resourceCount; id++)
+                    fits &= wanted[id] <= work[id];
+                if (!fits)
+                    continue;
+                const int32_t *held = &allocation[process * resourceCount];
+                for (size_t id = 0; id < resourceCount; id++)
+                    work[id] += held[id];
+                finished[word] |= uint64_t(1) << (process % 64);
+                progress = true;
+            }
+        }
+    }
+
+    vector<string> deadlocked;
+    for (size_t process = 0; process < processCount; process++)
+        if (!(finished[process / 64] >> (process % 64) & 1))
+            deadlocked.emplace_back(processes.name(int(process)));
+    return deadlocked;
+}
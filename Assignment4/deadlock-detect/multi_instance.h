@@ -0,0 +1,63 @@
+#pragma once
+
+#include "intern_table.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Class that stores the state of a system whose resources can have several instances (how many instances of every resource each process holds and waits for) and finds the deadlocked processes in it
+ * @note Uses the matrix based detection algorithm (like the Banker's safety check, but with the outstanding requests instead of the maximum claims). The request and allocation matrices are stored row by row so that checking or releasing a process is one pass over contiguous counts that the compiler vectorizes, and the finished processes are kept in a bitset
+ */
+class MultiInstanceState {
+public:
+    /**
+     * Function that sets the number of instances of a resource (resources that are never given one have a single instance)
+     * @param resource - Name of the resource
+     * @param instances - Number of instances
+     */
+    void setCapacity(std::string_view resource, int64_t instances);
+
+    /**
+     * Function that records that a process waits for instances of a resource (adds to what it already waits for)
+     * @param process - Name of the process
+     * @param resource - Name of the resource
+     * @param instances - Number of instances it waits for
+     */
+    void addRequest(std::string_view process, std::string_view resource, int64_t instances);
+
+    /**
+     * Function that records that a process holds instances of a resource (adds to what it already holds)
+     * @param process - Name of the process
+     * @param resource - Name of the resource
+     * @param instances - Number of instances it holds
+     */
+    void addAllocation(std::string_view process, std::string_view resource, int64_t instances);
+
+    /**
+     * Function that finds the processes that can never finish, even if every other process that can finish does and releases what it holds
+     * @note Throws std::runtime_error if more instances of a resource are held than it has
+     * @return vector - Names of the deadlocked processes, in the order they first appeared
+     */
+    std::vector<std::string> deadlockedProcesses() const;
+
+private:
+    // Custom data struct that stores a request or an allocation until the matrices are built
+    struct Entry {
+        int process;
+        int resource;
+        int64_t instances;
+    };
+
+    InternTable processes;
+    InternTable resources;
+
+    // Number of instances of every resource (-1 if it was never set)
+    std::vector<int64_t> capacity;
+
+    std::vector<Entry> requests;
+    std::vector<Entry> allocations;
+
+    int resource(std::string_view name);
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "common.h"
+#include "deadlock_ext.h"
+#include "intern_table.h"
+#include <algorithm>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Custom data struct that turns the process and resource names of the edges into unique integer ids
+struct NodeTable {
+    // Processes and resources are interned separately so that the same name can be used for both without adding a prefix
+    InternTable processes;
+    InternTable resources;
+
+    // Graph id of every process and resource (indexed by their id in the matching table)
+    std::vector<int> processNodes;
+    std::vector<int> resourceNodes;
+
+    // Id in the matching table of every graph node, alongside a bit per node that is set for processes
+    std::vector<int> localIds;
+    std::vector<bool> isProcess;
+
+    /**
+     * Function that returns the number of graph nodes handed out so far
+     * @return int - Number of nodes
+     */
+    int size() const { return int(localIds.size()); }
+
+    /**
+     * Function that returns the graph id of a name, giving it the next free id if it has not been seen before
+     * @param table - Table of the kind of node the name belongs to
+     * @param nodesOfTable - Graph ids of the nodes of that table
+     * @param name - Name of the node
+     * @param process - True if the name is a process
+     * @return int - Graph id of the node
+     */
+    int get(InternTable &table, std::vector<int> &nodesOfTable, std::string_view name, bool process) {
+        int local = table.get(name);
+        if (local == int(nodesOfTable.size())) {
+            nodesOfTable.push_back(size());
+            localIds.push_back(local);
+            isProcess.push_back(process);
+        }
+        return nodesOfTable[local];
+    }
+
+    /**
+     * Function that returns the graph id of a process, giving it the next free id if it has not been seen before
+     * @param name - Name of the process
+     * @return int - Graph id of the process
+     */
+    int process(std::string_view name) { return get(processes, processNodes, name, true); }
+
+    /**
+     * Function that returns the graph id of a resource, giving it the next free id if it has not been seen before
+     * @param name - Name of the resource
+     * @return int - Graph id of the resource
+     */
+    int resource(std::string_view name) { return get(resources, resourceNodes, name, false); }
+
+    /**
+     * Function that returns the graph id of a process without giving it one if it has not been seen before
+     * @param name - Name of the process
+     * @return int - Graph id of the process, or -1 if it is unknown
+     */
+    int findProcess(std::string_view name) const {
+        int local = processes.find(name);
+        return local == -1 ? -1 : processNodes[local];
+    }
+
+    /**
+     * Function that returns the graph id of a resource without giving it one if it has not been seen before
+     * @param name - Name of the resource
+     * @return int - Graph id of the resource, or -1 if it is unknown
+     */
+    int findResource(std::string_view name) const {
+        int local = resources.find(name);
+        return local == -1 ? -1 : resourceNodes[local];
+    }
+
+    /**
+     * Function that parses an edge string and returns the ids of the node that waits and the node it waits on
+     * @param edge - String composed of the process, the operator and the resource
+     * @return pair - Ids of the edge's start and end (a request makes the process wait on the resource, an assignment makes the resource wait on the process)
+     */
+    std::pair<int, int> parseEdge(std::string_view edge) {
+        // Splits the string in place into the process, operator and resource
+        std::string_view processName = next_token(edge);
+        std::string_view activity = next_token(edge);
+        std::string_view resourceName = next_token(edge);
+        int processId = process(processName);
+        int resourceId = resource(resourceName);
+        if (activity == "->")
+            return {processId, resourceId};
+        return {resourceId, processId};
+    }
+
+    /**
+     * Function that returns the name of a graph node
+     * @param node - Graph id of the node
+     * @return string_view - Name of the process or resource (only valid until the next new name is added)
+     */
+    std::string_view name(int node) const {
+        return isProcess[node] ? processes.name(localIds[node]) : resources.name(localIds[node]);
+    }
+
+    /**
+     * Function that adds the names of all the processes among the passed in nodes to the result
+     * @param nodes - Ids of the nodes that are in deadlock, in increasing order
+     * @param result - Result to add the process names to
+     */
+    void addProcesses(const std::vector<int> &nodes, Result &result) const {
+        for (int node : nodes)
+            if (isProcess[node])
+                result.dl_procs.emplace_back(name(node));
+    }
+
+    /**
+     * Function that fills in the cycle of the result and the processes that are blocked behind it
+     * @param cycle - Ids of the nodes on the cycle, each waiting on the next one
+     * @param reaching - Ids of all the nodes that can reach the cycle (the cycle included), in increasing order, processes that are not on the cycle are reported as blocked
+     * @param result - Result to fill in
+     */
+    void addCycle(const std::vector<int> &cycle, const std::vector<int> &reaching, DeadlockReport &result) const {
+        // Starts the cycle with a process (processes and resources alternate, so at most one step is needed)
+        size_t first = !cycle.empty() && !isProcess[cycle[0]] ? 1 : 0;
+        for (size_t index = 0; index < cycle.size(); index++)
+            result.cycle.emplace_back(name(cycle[(first + index) % cycle.size()]));
+
+        std::vector<int> onCycle(cycle);
+        std::sort(onCycle.begin(), onCycle.end());
+        for (int node : reaching)
+            if (isProcess[node] && !std::binary_search(onCycle.begin(), onCycle.end(), node))
+                result.blocked_procs.emplace_back(name(node));
+    }
+};
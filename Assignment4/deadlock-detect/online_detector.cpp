@@ -0,0 +1,53 @@
+#include "online_detector.h"
+
+using namespace std;
+
+DeadlockReport DeadlockDetector::add_request(string_view process, string_view resource) {
+    int processId = nodes.process(process);
+    return addEdge(processId, nodes.resource(resource));
+}
+
+DeadlockReport DeadlockDetector::add_assignment(string_view process, string_view resource) {
+    int processId = nodes.process(process);
+    return addEdge(nodes.resource(resource), processId);
+}
+
+bool DeadlockDetector::remove_edge(string_view process, string_view resource) {
+    eventCount++;
+    int processId = nodes.findProcess(process);
+    int resourceId = nodes.findResource(resource);
+    if (processId == -1 || resourceId == -1)
+        return false;
+
+    // Only one direction can exist, both at once would be a cycle
+    return graph.removeEdge(processId, resourceId) || graph.removeEdge(resourceId, processId);
+}
+
+/**
+ * Function that adds an edge to the graph unless it closes a cycle
+ * @param from - Id of the node that waits
+ * @param to - Id of the node it waits on
+ * @return DeadlockReport - Deadlock caused by the edge (edge_index is -1 if there is none)
+ */
+DeadlockReport DeadlockDetector::addEdge(int from, int to) {
+    DeadlockReport result;
+    result.edge_index = -1;
+    int event = eventCount++;
+
+    // Adds a node to the graph for every new id
+    while (graph.size() < nodes.size())
+        graph.addNode();
+    if (graph.addEdge(from, to))
+        return result;
+
+    // The edge closes a cycle, every process that can reach the edge's start is either on the cycle or waiting on it
+    result.edge_index = event;
+    if (!reportBlocked) {
+        nodes.addCycle(graph.lastCycle(), {}, result);
+        return result;
+    }
+    vector<int> reaching = graph.nodesReaching(from);
+    nodes.addProcesses(reaching, result);
+    nodes.addCycle(graph.lastCycle(), reaching, result);
+    return result;
+}
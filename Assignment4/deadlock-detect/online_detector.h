@@ -0,0 +1,57 @@
+#pragma once
+
+#include "deadlock_ext.h"
+#include "dynamic_topo_order.h"
+#include "node_table.h"
+#include <string_view>
+
+/**
+ * Class that keeps the resource allocation graph of a running system up to date one event at a time and reports a deadlock the moment an event creates one
+ * @note The graph keeps a dynamic topological order (see DynamicTopoOrder), so an event only touches the nodes whose order lies between the edge's endpoints and removing an edge never has to touch the order at all. An edge that would close a cycle is reported and not added, so the graph stays acyclic (like a lock manager refusing the request that would deadlock)
+ */
+class DeadlockDetector {
+public:
+    /**
+     * Constructor that creates a detector with an empty graph
+     * @param report_blocked - True to also report the processes waiting on a cycle (dl_procs and blocked_procs), which needs a walk over every node that can reach the cycle. When false only the cycle itself is reported, it comes straight out of the search that found it
+     */
+    explicit DeadlockDetector(bool report_blocked = true) : reportBlocked(report_blocked) {}
+
+    /**
+     * Function that records that a process waits for a resource
+     * @param process - Name of the process
+     * @param resource - Name of the resource
+     * @return DeadlockReport - edge_index is the number of the event (counting from 0) if the request closes a cycle and -1 otherwise, cycle is the cycle it would close, dl_procs and blocked_procs are the processes in deadlock and the ones waiting on the cycle
+     */
+    DeadlockReport add_request(std::string_view process, std::string_view resource);
+
+    /**
+     * Function that records that a resource is held by a process
+     * @param process - Name of the process
+     * @param resource - Name of the resource
+     * @return DeadlockReport - edge_index is the number of the event (counting from 0) if the assignment closes a cycle and -1 otherwise, cycle is the cycle it would close, dl_procs and blocked_procs are the processes in deadlock and the ones waiting on the cycle
+     */
+    DeadlockReport add_assignment(std::string_view process, std::string_view resource);
+
+    /**
+     * Function that removes the request or assignment between a process and a resource (the request was granted or the resource released)
+     * @param process - Name of the process
+     * @param resource - Name of the resource
+     * @return bool - True if there was such an edge
+     */
+    bool remove_edge(std::string_view process, std::string_view resource);
+
+    /**
+     * Function that returns the number of events processed so far
+     * @return int - Number of calls to add_request(), add_assignment() and remove_edge()
+     */
+    int events() const { return eventCount; }
+
+private:
+    DynamicTopoOrder graph;
+    NodeTable nodes;
+    int eventCount = 0;
+    bool reportBlocked;
+
+    DeadlockReport addEdge(int from, int to);
+};
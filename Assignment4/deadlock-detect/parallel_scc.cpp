@@ -0,0 +1,278 @@
+#include "parallel_scc.h"
+#include <pthread.h>
+#include <atomic>
+#include <deque>
+
+using namespace std;
+
+// Custom data struct that stores the edges of every node in compressed form, in both directions
+struct StaticGraph {
+    // The edges leaving node v are at positions outStart[v] .. outStart[v + 1] - 1 of outTargets (same for the entering ones)
+    vector<int> outStart, outTargets;
+    vector<int> inStart, inSources;
+
+    StaticGraph(int nodeCount, const vector<pair<int, int>> &edges)
+        : outStart(nodeCount + 1, 0), outTargets(edges.size()), inStart(nodeCount + 1, 0), inSources(edges.size()) {
+        for (auto &edge : edges) {
+            outStart[edge.first + 1]++;
+            inStart[edge.second + 1]++;
+        }
+        for (int node = 0; node < nodeCount; node++) {
+            outStart[node + 1] += outStart[node];
+            inStart[node + 1] += inStart[node];
+        }
+        vector<int> nextOut(outStart.begin(), outStart.end() - 1);
+        vector<int> nextIn(inStart.begin(), inStart.end() - 1);
+        for (auto &edge : edges) {
+            outTargets[nextOut[edge.first]++] = edge.second;
+            inSources[nextIn[edge.second]++] = edge.first;
+        }
+    }
+};
+
+// Custom data struct that stores the state shared by the threads trimming the graph
+struct TrimWork {
+    const StaticGraph *graph;
+    int nodeCount;
+    int nThreads;
+    // Number of entering and leaving edges every node still has from nodes that were not trimmed
+    vector<atomic<int>> inDegree, outDegree;
+    // 1 while the node has not been trimmed
+    vector<atomic<char>> alive;
+
+    TrimWork(const StaticGraph *graph, int nodeCount, int nThreads)
+        : graph(graph), nodeCount(nodeCount), nThreads(nThreads), inDegree(nodeCount), outDegree(nodeCount),
+          alive(nodeCount) {}
+};
+
+// Custom data struct that stores the data given to each trimming thread
+struct TrimThread {
+    TrimWork *work;
+    int index;
+};
+
+/**
+ * Function that will be used by threads to trim the graph (starts with the nodes of its own range and then follows every node whose last entering or leaving edge it removed)
+ * @note No thread waits for another one, a node is trimmed by whichever thread wins the compare and swap of its alive flag
+ * @param input - Pointer that will contain the TrimThread struct of the thread
+ */
+static void *trimThreadWork(void *input) {
+    auto *thread = (TrimThread *) input;
+    TrimWork &work = *thread->work;
+    const StaticGraph &graph = *work.graph;
+
+    // Every node of the thread's range that has no entering or no leaving edge can be trimmed right away
+    vector<int> worklist;
+    int first = int(int64_t(work.nodeCount) * thread->index / work.nThreads);
+    int last = int(int64_t(work.nodeCount) * (thread->index + 1) / work.nThreads);
+    for (int node = first; node < last; node++)
+        if (graph.inStart[node] == graph.inStart[node + 1] || graph.outStart[node] == graph.outStart[node + 1]) {
+            work.alive[node].store(0, memory_order_relaxed);
+            worklist.push_back(node);
+        }
+
+    // Removes the edges of every trimmed node, a neighbor that runs out of entering or leaving edges is trimmed as well
+    auto trim = [&](int node) {
+        char expected = 1;
+        if (work.alive[node].compare_exchange_strong(expected, 0, memory_order_relaxed))
+            worklist.push_back(node);
+    };
+    while (!worklist.empty()) {
+        int node = worklist.back();
+        worklist.pop_back();
+        for (int index = graph.outStart[node]; index < graph.outStart[node + 1]; index++)
+            if (work.inDegree[graph.outTargets[index]].fetch_sub(1, memory_order_relaxed) == 1)
+                trim(graph.outTargets[index]);
+        for (int index = graph.inStart[node]; index < graph.inStart[node + 1]; index++)
+            if (work.outDegree[graph.inSources[index]].fetch_sub(1, memory_order_relaxed) == 1)
+                trim(graph.inSources[index]);
+    }
+    return nullptr;
+}
+
+// Custom data struct that stores the state shared by the threads splitting the remaining nodes into strongly connected components
+struct SplitWork {
+    const StaticGraph *graph;
+    // Color of the part every node belongs to (-1 once its component is known), only nodes of the same part are searched together
+    vector<atomic<int>> color;
+    // Next unused color
+    atomic<int> nextColor{1};
+    // Marks of the forward and backward searches (only touched by the thread that owns the node's part)
+    vector<char> forward, backward;
+    // Result, 1 for every node on a cycle
+    vector<char> *onCycle;
+
+    // Parts that still have to be split, alongside the number of parts that are queued or being split
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t changed = PTHREAD_COND_INITIALIZER;
+    deque<vector<int>> parts;
+    int pending = 0;
+
+    SplitWork(const StaticGraph *graph, int nodeCount, vector<char> *onCycle)
+        : graph(graph), color(nodeCount), forward(nodeCount, 0), backward(nodeCount, 0), onCycle(onCycle) {}
+};
+
+/**
+ * Function that marks every node of the passed in color that can be reached from start by following edges in one direction
+ * @param start - Node to start at
+ * @param partColor - Color of the part being split
+ * @param edgeStart - Offsets of the edges to follow
+ * @param edgeEnds - Other ends of the edges to follow
+ * @param color - Colors of the nodes
+ * @param marks - Marks to set
+ * @param stack - Stack to use (left empty)
+ */
+static void markReachable(int start, int partColor, const vector<int> &edgeStart, const vector<int> &edgeEnds,
+                          const vector<atomic<int>> &color, vector<char> &marks, vector<int> &stack) {
+    marks[start] = 1;
+    stack.assign(1, start);
+    while (!stack.empty()) {
+        int node = stack.back();
+        stack.pop_back();
+        for (int index = edgeStart[node]; index < edgeStart[node + 1]; index++) {
+            int next = edgeEnds[index];
+            if (color[next].load(memory_order_relaxed) == partColor && !marks[next]) {
+                marks[next] = 1;
+                stack.push_back(next);
+            }
+        }
+    }
+}
+
+/**
+ * Function that checks whether a node has an edge to itself
+ * @param graph - Graph the node belongs to
+ * @param node - Id of the node
+ * @return bool - True if the node has a self loop
+ */
+static bool hasSelfLoop(const StaticGraph &graph, int node) {
+    for (int index = graph.outStart[node]; index < graph.outStart[node + 1]; index++)
+        if (graph.outTargets[index] == node)
+            return true;
+    return false;
+}
+
+/**
+ * Function that splits a part into the strongly connected component of its first node and up to three smaller parts (the nodes only reached forward, only reached backward and not reached at all)
+ * @param work - State shared by the threads
+ * @param part - Nodes of the part, all of the same color
+ * @param stack - Stack to use for the searches
+ * @return vector - Parts that still have to be split
+ */
+static vector<vector<int>> splitPart(SplitWork &work, const vector<int> &part, vector<int> &stack) {
+    const StaticGraph &graph = *work.graph;
+    int pivot = part[0];
+    int partColor = work.color[pivot].load(memory_order_relaxed);
+    markReachable(pivot, partColor, graph.outStart, graph.outTargets, work.color, work.forward, stack);
+    markReachable(pivot, partColor, graph.inStart, graph.inSources, work.color, work.backward, stack);
+
+    // The nodes reached in both directions form the pivot's component
+    vector<vector<int>> pieces(3);
+    vector<int> component;
+    for (int node : part) {
+        if (work.forward[node] && work.backward[node])
+            component.push_back(node);
+        else
+            pieces[work.forward[node] ? 0 : work.backward[node] ? 1 : 2].push_back(node);
+        work.forward[node] = work.backward[node] = 0;
+    }
+    bool cyclic = component.size() > 1 || hasSelfLoop(graph, pivot);
+    for (int node : component) {
+        (*work.onCycle)[node] = cyclic;
+        work.color[node].store(-1, memory_order_relaxed);
+    }
+
+    // Gives every piece its own color so that the searches of different pieces never cross (a single node is its own component right away)
+    vector<vector<int>> remaining;
+    int firstColor = work.nextColor.fetch_add(3);
+    for (int piece = 0; piece < 3; piece++) {
+        if (pieces[piece].size() == 1) {
+            int node = pieces[piece][0];
+            (*work.onCycle)[node] = hasSelfLoop(graph, node);
+            work.color[node].store(-1, memory_order_relaxed);
+            continue;
+        }
+        for (int node : pieces[piece])
+            work.color[node].store(firstColor + piece, memory_order_relaxed);
+        if (!pieces[piece].empty())
+            remaining.push_back(move(pieces[piece]));
+    }
+    return remaining;
+}
+
+/**
+ * Function that will be used by threads to split parts until every strongly connected component is found
+ * @param input - Pointer that will contain the SplitWork struct shared by all the threads
+ */
+static void *splitThreadWork(void *input) {
+    auto *work = (SplitWork *) input;
+    vector<int> stack;
+    while (true) {
+        // Waits for a part to split, stops once no part is queued or being split
+        pthread_mutex_lock(&work->lock);
+        while (work->parts.empty() && work->pending > 0)
+            pthread_cond_wait(&work->changed, &work->lock);
+        if (work->parts.empty()) {
+            pthread_mutex_unlock(&work->lock);
+            break;
+        }
+        vector<int> part = move(work->parts.front());
+        work->parts.pop_front();
+        pthread_mutex_unlock(&work->lock);
+
+        vector<vector<int>> remaining = splitPart(*work, part, stack);
+
+        // Queues the smaller parts and wakes up the waiting threads
+        pthread_mutex_lock(&work->lock);
+        for (auto &piece : remaining) {
+            work->parts.push_back(move(piece));
+            work->pending++;
+        }
+        work->pending--;
+        pthread_cond_broadcast(&work->changed);
+        pthread_mutex_unlock(&work->lock);
+    }
+    return nullptr;
+}
+
+vector<char> nodesOnCycles(int nodeCount, const vector<pair<int, int>> &edges, int nThreads) {
+    StaticGraph graph(nodeCount, edges);
+    vector<char> onCycle(nodeCount, 0);
+    if (nThreads < 1)
+        nThreads = 1;
+
+    // Trims every node that has no entering or no leaving edge left, until none is left
+    TrimWork trim(&graph, nodeCount, nThreads);
+    for (int node = 0; node < nodeCount; node++) {
+        trim.inDegree[node].store(graph.inStart[node + 1] - graph.inStart[node], memory_order_relaxed);
+        trim.outDegree[node].store(graph.outStart[node + 1] - graph.outStart[node], memory_order_relaxed);
+        trim.alive[node].store(1, memory_order_relaxed);
+    }
+    vector<pthread_t> threadsArray(nThreads);
+    vector<TrimThread> trimThreads(nThreads);
+    for (int index = 0; index < nThreads; index++) {
+        trimThreads[index] = {&trim, index};
+        pthread_create(&threadsArray[index], nullptr, trimThreadWork, (void *) &trimThreads[index]);
+    }
+    for (auto &thread : threadsArray)
+        pthread_join(thread, nullptr);
+
+    // Every node that is left lies on a cycle or between two cycles, those are split up into components
+    SplitWork split(&graph, nodeCount, &onCycle);
+    vector<int> remaining;
+    for (int node = 0; node < nodeCount; node++) {
+        bool alive = trim.alive[node].load(memory_order_relaxed);
+        split.color[node].store(alive ? 0 : -1, memory_order_relaxed);
+        if (alive)
+            remaining.push_back(node);
+    }
+    if (remaining.empty())
+        return onCycle;
+    split.parts.push_back(move(remaining));
+    split.pending = 1;
+    for (auto &thread : threadsArray)
+        pthread_create(&thread, nullptr, splitThreadWork, (void *) &split);
+    for (auto &thread : threadsArray)
+        pthread_join(thread, nullptr);
+    return onCycle;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+/**
+ * Function that finds every node of a directed graph that lies on a cycle (every node of a strongly connected component with more than one node, or with a self loop)
+ * @note Nodes that cannot be on a cycle because nothing points at them or they point at nothing are first trimmed away in parallel, the strongly connected components of what is left are then split up with the forward-backward algorithm, the threads taking turns on the independent parts
+ * @param nodeCount - Number of nodes (ids go from 0 to nodeCount - 1)
+ * @param edges - Edges as (from, to) pairs
+ * @param nThreads - Number of threads to use
+ * @return vector - 1 for every node that lies on a cycle, 0 for every other node
+ */
+std::vector<char> nodesOnCycles(int nodeCount, const std::vector<std::pair<int, int>> &edges, int nThreads);
@@ -0,0 +1,82 @@
+#include "prefix_graph.h"
+#include <algorithm>
+
+using namespace std;
+
+PrefixGraph::PrefixGraph(int nodeCount, const vector<pair<int, int>> &edges)
+    : rowStart(nodeCount + 1, 0), edgeSources(edges.size()), edgeIds(edges.size()), edgeFrom(edges.size()), edgeTo(edges.size()),
+      outDegree(nodeCount), queue(nodeCount) {
+    // Counts the incoming edges of every node and turns the counts into row offsets
+    for (auto &edge : edges)
+        rowStart[edge.second + 1]++;
+    for (int node = 0; node < nodeCount; node++)
+        rowStart[node + 1] += rowStart[node];
+
+    // Fills every row in list order, so each row is sorted by edge id
+    vector<int> nextSlot(rowStart.begin(), rowStart.end() - 1);
+    for (int id = 0; id < int(edges.size()); id++) {
+        int slot = nextSlot[edges[id].second]++;
+        edgeSources[slot] = edges[id].first;
+        edgeIds[slot] = id;
+        edgeFrom[id] = edges[id].first;
+        edgeTo[id] = edges[id].second;
+    }
+}
+
+bool PrefixGraph::hasCycle(int prefixLength) {
+    // Counts the outgoing edges of every node that are part of the prefix
+    fill(outDegree.begin(), outDegree.end(), 0);
+    for (int id = 0; id < prefixLength; id++)
+        outDegree[edgeFrom[id]]++;
+
+    // Starts with every node that waits on nothing
+    int head = 0, tail = 0;
+    for (int node = 0; node < int(outDegree.size()); node++)
+        if (outDegree[node] == 0)
+            queue[tail++] = node;
+
+    // Removes those nodes one by one, a node whose last outgoing edge is removed waits on nothing as well
+    while (head < tail) {
+        int node = queue[head++];
+        for (int slot = rowStart[node]; slot < rowStart[node + 1] && edgeIds[slot] < prefixLength; slot++)
+            if (--outDegree[edgeSources[slot]] == 0)
+                queue[tail++] = edgeSources[slot];
+    }
+
+    // Any node that could not be removed is on a cycle or waits on one
+    return tail < int(outDegree.size());
+}
+
+vector<int> PrefixGraph::blockedNodes() const {
+    vector<int> blocked;
+    for (int node = 0; node < int(outDegree.size()); node++)
+        if (outDegree[node] > 0)
+            blocked.push_back(node);
+    return blocked;
+}
+
+vector<int> PrefixGraph::cycleThroughLastEdge(int prefixLength) const {
+    int lastEdge = prefixLength - 1;
+    int from = edgeFrom[lastEdge], to = edgeTo[lastEdge];
+
+    // Walks the incoming edges back from the edge's start until its end is found, next[v] is the node v was reached from (the one it waits on)
+    vector<int> next(outDegree.size(), -1);
+    vector<int> found{from};
+    next[from] = from;
+    for (size_t index = 0; index < found.size() && next[to] == -1; index++) {
+        int node = found[index];
+        for (int slot = rowStart[node]; slot < rowStart[node + 1] && edgeIds[slot] < lastEdge; slot++) {
+            int previous = edgeSources[slot];
+            if (next[previous] == -1 && outDegree[previous] > 0) {
+                next[previous] = node;
+                found.push_back(previous);
+            }
+        }
+    }
+
+    // Follows the path from the edge's end forward to its start
+    vector<int> cycle{from};
+    for (int node = to; node != from; node = next[node])
+        cycle.push_back(node);
+    return cycle;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+/**
+ * Class that stores a fixed list of directed edges in compressed sparse row form and checks whether the graph made of only the first k edges has a cycle
+ * @note Every incoming edge keeps the position it had in the list, so the same arrays answer the check for any prefix length without being rebuilt
+ */
+class PrefixGraph {
+public:
+    /**
+     * Constructor that builds the compressed incoming edge lists
+     * @param nodeCount - Number of nodes (ids go from 0 to nodeCount - 1)
+     * @param edges - Edges as (from, to) pairs, in the order they were added
+     */
+    PrefixGraph(int nodeCount, const std::vector<std::pair<int, int>> &edges);
+
+    /**
+     * Function that checks whether the first prefixLength edges contain a cycle (linear time, repeatedly removes nodes that wait on nothing)
+     * @param prefixLength - Number of edges to consider, starting with the first one
+     * @return bool - True if the prefix contains a cycle
+     */
+    bool hasCycle(int prefixLength);
+
+    /**
+     * Function that returns the nodes that were left over by the last hasCycle() call, those are the nodes on a cycle or waiting on one
+     * @return vector - Ids of the left over nodes, in increasing order
+     */
+    std::vector<int> blockedNodes() const;
+
+    /**
+     * Function that finds a cycle through the last edge of the prefix checked by the last hasCycle() call (only the left over nodes are searched)
+     * @note Only valid if the prefix without its last edge has no cycle, which is the case for the shortest cyclic prefix
+     * @param prefixLength - Length of the prefix passed to the last hasCycle() call
+     * @return vector - Ids of the nodes on the cycle, starting with the last edge's start and then its end, each node waiting on the next one
+     */
+    std::vector<int> cycleThroughLastEdge(int prefixLength) const;
+
+    /**
+     * Function that returns the number of edges the graph was built with
+     * @return int - Number of edges
+     */
+    int edgeCount() const { return int(edgeSources.size()); }
+
+private:
+    // Incoming edges of node v are at positions rowStart[v] .. rowStart[v + 1] - 1 of edgeSources and edgeIds
+    std::vector<int> rowStart;
+    std::vector<int> edgeSources;
+    std::vector<int> edgeIds;
+
+    // Start and end of every edge in list order (the starts are used to count the outgoing edges of a prefix)
+    std::vector<int> edgeFrom;
+    std::vector<int> edgeTo;
+
+    // Outgoing edges that every node still has in the prefix that was checked last (reused by every check)
+    std::vector<int> outDegree;
+
+    // Queue of the nodes that wait on nothing (reused by every check)
+    std::vector<int> queue;
+};
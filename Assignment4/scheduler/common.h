@@ -9,6 +9,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 #include <sstream>
@@ -18,10 +19,55 @@
 /// return string includes trailing '\n' if present
 std::string stdin_readline();
 
+/// reads lines from a file descriptor without copying them
+/// regular files (including stdin redirected from a file) are mapped into
+/// memory, anything else (pipes, terminals) is read in 1MiB blocks
+/// stdin_readline() is a wrapper around a LineReader for stdin
+///
+/// example:
+///   LineReader reader(0);
+///   std::string_view line;
+///   while (reader.next(line)) { ... }
+///
+class LineReader {
+public:
+    /// the descriptor is not closed by the reader
+    explicit LineReader(int fd = 0);
+
+    ~LineReader();
+
+    LineReader(const LineReader &) = delete;
+
+    LineReader &operator=(const LineReader &) = delete;
+
+    /// stores the next line in line and returns true, returns false on EOF
+    /// the line includes the trailing '\n' if present and is only valid
+    /// until the next call
+    bool next(std::string_view &line);
+
+private:
+    int fd;
+
+    // the mapped file (mapped == nullptr if the descriptor is read in blocks)
+    const char *mapped = nullptr;
+    size_t mapped_size = 0;
+
+    // block buffer, the unread bytes are at positions pos .. end - 1
+    std::vector<char> buffer;
+    size_t pos = 0;
+    size_t end = 0;
+    bool eof = false;
+};
+
 /// splits string into tokens (words)
 /// separators are sequences of white spaces
 std::vector<std::string> split(const std::string &str);
 
+/// returns the next token (word) of str without copying it, and removes the
+/// token and the white space in front of it from str
+/// returns an empty string_view when str has no tokens left
+std::string_view next_token(std::string_view &str);
+
 /// joins a vector of strings into a single string, using a separator
 std::string join(const std::vector<std::string> &toks, const std::string &sep = " ");
 
@@ -30,7 +76,7 @@ std::string join(const std::vector<std::string> &toks, const std::string &sep =
 std::string simplify(const std::string &str);
 
 /// check if string is alphanumeric
-bool is_alnum(const std::string &str);
+bool is_alnum(std::string_view str);
 
 /// HIDDEN HINT: this "may" help you get a bit more performance
 /// in your cycle finding algorithm, since indexed arrays are faster
@@ -44,19 +44,21 @@ static int run_sched(int64_t quantum, int64_t max_seq_len) {
     // read in the process information from stdin
     int line_no = 0;
     std::vector<Process> processes;
-    while (1) {
-        // read in the next line and quit loop on EOF
-        auto line = stdin_readline();
-        if (line.size() == 0) break;
+    LineReader reader(0);
+    std::string_view line;
+    while (reader.next(line)) {
         line_no++;
-        auto toks = split(line);
-        if (toks.size() == 0) continue;
+        std::string_view rest = line, toks[3];
+        int ntoks = 0;
+        while (ntoks < 3 && !(toks[ntoks] = next_token(rest)).empty())
+            ntoks++;
+        if (ntoks == 0) continue;
         try {
-            if (toks.size() != 2) throw fatal_error() << "need 2 ints per line";
+            if (ntoks != 2) throw fatal_error() << "need 2 ints per line";
             Process p;
             p.id = processes.size();
-            p.arrival_time = std::stoll(toks[0]);
-            p.burst = std::stoll(toks[1]);
+            p.arrival_time = std::stoll(std::string(toks[0]));
+            p.burst = std::stoll(std::string(toks[1]));
             processes.push_back(p);
         } catch (std::exception &e) {
             std::cout << "Error on line " << line_no << ": " << e.what() << "\n";
@@ -0,0 +1,221 @@
+#include "common.h"
+#include "scheduler_ext.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <vector>
+
+using VS = std::vector<std::string>;
+
+// entry point of the extended modes (other policies, several cores and the
+// metrics summary), kept apart from main.cpp so the assignment driver stays
+// untouched
+
+static void print_procs(const std::vector<Process> &procs, int indent = 0) {
+    std::string inds(indent, ' ');
+    std::cout << inds
+              << "+---------------------------+----------------------+----------------------+------"
+                 "----------------+\n"
+              << inds
+              << "| Id |              Arrival |                Burst |                Start |      "
+                 "         Finish |\n"
+              << inds
+              << "+---------------------------+----------------------+----------------------+------"
+                 "----------------+\n";
+    for (const auto &p : procs) {
+        std::cout << inds << "| " << std::setw(2) << std::right << p.id << " | " << std::setw(20)
+                  << p.arrival_time << " | " << std::setw(20) << p.burst << " | " << std::setw(20)
+                  << p.start_time << " | " << std::setw(20) << p.finish_time << " |"
+                  << "\n";
+    }
+    std::cout << inds
+              << "+---------------------------+----------------------+----------------------+------"
+                 "----------------+\n";
+}
+
+// reads the processes, and the priority of every process into priorities
+static std::vector<Process> read_procs(std::vector<int64_t> &priorities) {
+    std::cout << "Reading in lines from stdin...\n";
+
+    // read in the process information from stdin
+    int line_no = 0;
+    std::vector<Process> processes;
+    LineReader reader(0);
+    std::string_view line;
+    while (reader.next(line)) {
+        line_no++;
+        std::string_view rest = line, toks[4];
+        int ntoks = 0;
+        while (ntoks < 4 && !(toks[ntoks] = next_token(rest)).empty())
+            ntoks++;
+        if (ntoks == 0) continue;
+        try {
+            if (ntoks != 2 && ntoks != 3) throw fatal_error() << "need 2 or 3 ints per line";
+            Process p;
+            p.id = processes.size();
+            p.arrival_time = std::stoll(std::string(toks[0]));
+            p.burst = std::stoll(std::string(toks[1]));
+            priorities.push_back(ntoks == 3 ? std::stoll(std::string(toks[2])) : 0);
+            processes.push_back(p);
+        } catch (std::exception &e) {
+            std::cout << "Error on line " << line_no << ": " << e.what() << "\n";
+            exit(-1);
+        }
+    }
+    return processes;
+}
+
+static void print_seq(const std::string &name, const std::vector<int> &seq) {
+    std::cout << name << " = [";
+    bool comma = false;
+    for (auto p : seq) {
+        if (comma) std::cout << ","; else comma = true;
+        std::cout << p;
+    }
+    std::cout << "]\n";
+}
+
+static void print_distribution(const std::string &name, const Distribution &d) {
+    std::cout << "\"" << name << "\":{\"mean\":" << std::fixed << std::setprecision(4) << d.mean
+              << ",\"p50\":" << d.p50 << ",\"p95\":" << d.p95 << ",\"p99\":" << d.p99 << "}";
+}
+
+// prints the metrics as a single JSON object
+static void print_metrics(const Metrics &m) {
+    std::cout << "metrics = {\"processes\":" << m.processes << ",";
+    print_distribution("turnaround", m.turnaround);
+    std::cout << ",";
+    print_distribution("waiting", m.waiting);
+    std::cout << ",";
+    print_distribution("response", m.response);
+    std::cout << ",\"utilization\":" << std::fixed << std::setprecision(6) << m.utilization
+              << ",\"context_switches\":" << m.context_switches << "}\n";
+}
+
+static int run_sched(Policy policy, PolicyOptions options, int64_t max_seq_len) {
+    std::vector<Process> processes = read_procs(options.priorities);
+    std::vector<int> seq{-2, 1000000, 5000};
+    Metrics metrics;
+    std::cout << "Running simulate_policy(q=" << options.quantum << ",aging=" << options.aging
+              << ",levels=" << options.levels << ",maxs=" << max_seq_len << ",procs=["
+              << processes.size() << "])\n";
+    Timer timer;
+    simulate_policy(policy, options, max_seq_len, processes, seq, &metrics);
+    std::cout << "Elapsed time  : " << std::fixed << std::setprecision(4) << timer.elapsed()
+              << "s\n\n";
+    print_seq("seq", seq);
+    print_metrics(metrics);
+    print_procs(processes);
+
+    return 0;
+}
+
+static int run_multicore(const MultiCoreOptions &options, int64_t max_seq_len) {
+    std::vector<int64_t> priorities;
+    std::vector<Process> processes = read_procs(priorities);
+    std::vector<std::vector<int>> seqs{{-2, 1000000, 5000}};
+    Metrics metrics;
+    std::cout << "Running simulate_multicore(q=" << options.quantum << ",cores=" << options.cores
+              << ",switch=" << options.switch_cost << ",migration=" << options.migration_cost
+              << ",maxs=" << max_seq_len << ",procs=[" << processes.size() << "])\n";
+    Timer timer;
+    simulate_multicore(options, max_seq_len, processes, seqs, &metrics);
+    std::cout << "Elapsed time  : " << std::fixed << std::setprecision(4) << timer.elapsed()
+              << "s\n\n";
+    for (size_t core = 0; core < seqs.size(); core++)
+        print_seq("seq[" + std::to_string(core) + "]", seqs[core]);
+    print_metrics(metrics);
+    print_procs(processes);
+
+    return 0;
+}
+
+static int usage(const std::string &pname) {
+    std::cout << "Usage:\n"
+              << "    " << pname << " quantum max_seq_len [policy [aging|levels]]\n"
+              << "    " << pname
+              << " quantum max_seq_len cores n [none|least|steal [switch_cost [migration_cost]]]\n"
+              << "        - input lines are \"arrival burst [priority]\"\n"
+              << "        - policy is one of rr (default), fcfs, sjf, srtf, priority, mlfq\n"
+              << "        - aging is the waiting time per priority level gained (priority,\n"
+              << "          default 0 = no aging)\n"
+              << "        - levels is the number of queues (mlfq, default 3)\n"
+              << "        - cores runs round robin on n cores with a queue each, processes\n"
+              << "          stay on core id % n (none, default), go to the core with the\n"
+              << "          fewest processes (least) or are stolen by idle cores (steal)\n";
+    return -1;
+}
+
+static int cppmain(const VS &args) {
+    // parse arguments
+    if (args.size() >= 5 && args[3] == "cores") {
+        static const std::pair<const char *, Balancing> balancings[] = {
+            {"none", Balancing::None}, {"least", Balancing::LeastLoaded},
+            {"steal", Balancing::WorkStealing}};
+        if (args.size() > 8)
+            return usage(args[0]);
+        MultiCoreOptions options;
+        if (args.size() >= 6) {
+            auto found = std::find_if(std::begin(balancings), std::end(balancings),
+                                      [&](auto &entry) { return args[5] == entry.first; });
+            if (found == std::end(balancings))
+                return usage(args[0]);
+            options.balancing = found->second;
+        }
+        try {
+            options.quantum = std::stoll(args[1]);
+            int64_t max_seq_len = std::stoll(args[2]);
+            options.cores = std::stoi(args[4]);
+            if (args.size() >= 7) options.switch_cost = std::stoll(args[6]);
+            if (args.size() >= 8) options.migration_cost = std::stoll(args[7]);
+            if (options.quantum < 1 || options.cores < 1 || options.cores > 4096
+                || options.switch_cost < 0 || options.migration_cost < 0)
+                return usage(args[0]);
+            return run_multicore(options, max_seq_len);
+        } catch (...) {
+            std::cout << "Could not parse command line arguments.\n";
+            return usage(args[0]);
+        }
+    }
+    if (args.size() < 3 || args.size() > 5)
+        return usage(args[0]);
+
+    static const std::pair<const char *, Policy> policies[] = {
+        {"rr", Policy::RoundRobin}, {"fcfs", Policy::Fcfs}, {"sjf", Policy::Sjf},
+        {"srtf", Policy::Srtf}, {"priority", Policy::Priority}, {"mlfq", Policy::Mlfq}};
+    Policy policy = Policy::RoundRobin;
+    if (args.size() >= 4) {
+        auto found = std::find_if(std::begin(policies), std::end(policies),
+                                  [&](auto &entry) { return args[3] == entry.first; });
+        if (found == std::end(policies))
+            return usage(args[0]);
+        policy = found->second;
+    }
+    if (args.size() == 5 && policy != Policy::Priority && policy != Policy::Mlfq)
+        return usage(args[0]);
+
+    try {
+        PolicyOptions options;
+        options.quantum = std::stoll(args[1]);
+        int64_t max_seq_len = std::stoll(args[2]);
+        if (args.size() == 5 && policy == Policy::Priority)
+            options.aging = std::stoll(args[4]);
+        if (args.size() == 5 && policy == Policy::Mlfq)
+            options.levels = std::stoi(args[4]);
+        if (options.quantum < 1 || options.aging < 0 || options.levels < 1 || options.levels > 62)
+            return usage(args[0]);
+        return run_sched(policy, options, max_seq_len);
+    } catch (...) {
+        std::cout << "Could not parse command line arguments.\n";
+        return usage(args[0]);
+    }
+}
+
+int main(int argc, char **argv) {
+    return cppmain({argv + 0, argv + argc});
+}
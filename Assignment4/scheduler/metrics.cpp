@@ -0,0 +1,94 @@
+#include "metrics.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// Number of bits below the highest set bit that pick the bucket within a power of two
+static const int subBits = 7;
+
+/**
+ * Function that returns the bucket a value falls into
+ * @param value - Non-negative value
+ * @return int - Index of the bucket
+ */
+static int bucketOf(int64_t value) {
+    if (value < (int64_t(1) << subBits))
+        return int(value);
+    int exponent = 63 - __builtin_clzll(uint64_t(value));
+    return ((exponent - subBits + 1) << subBits) + int((value >> (exponent - subBits)) & ((1 << subBits) - 1));
+}
+
+/**
+ * Function that returns the value in the middle of a bucket
+ * @param bucket - Index of the bucket
+ * @return int64_t - Middle of the range of values of the bucket
+ */
+static int64_t middleOf(int bucket) {
+    if (bucket < (2 << subBits))
+        return bucket;
+    int exponent = (bucket >> subBits) + subBits - 1;
+    int64_t lowest = (int64_t((1 << subBits) + (bucket & ((1 << subBits) - 1)))) << (exponent - subBits);
+    int64_t width = int64_t(1) << (exponent - subBits);
+    return lowest + (width - 1) / 2;
+}
+
+QuantileSketch::QuantileSketch() : counts((64 - subBits) << subBits, 0) {}
+
+void QuantileSketch::add(int64_t value) {
+    value = max(value, int64_t(0));
+    counts[bucketOf(value)]++;
+    minimum = total == 0 ? value : min(minimum, value);
+    maximum = total == 0 ? value : max(maximum, value);
+    total++;
+    sum += double(value);
+}
+
+/**
+ * Function that returns the smallest value that at least the given fraction of the values are not above (nearest rank)
+ * @param fraction - Fraction of the values, between 0 and 1
+ * @return int64_t - Middle of the bucket the value falls into, kept between the smallest and largest value added
+ */
+int64_t QuantileSketch::quantile(double fraction) const {
+    int64_t rank = max(int64_t(1), int64_t(ceil(fraction * double(total))));
+    int64_t seen = 0;
+    for (size_t bucket = 0; bucket < counts.size(); bucket++) {
+        seen += counts[bucket];
+        if (seen >= rank)
+            return min(maximum, max(minimum, middleOf(int(bucket))));
+    }
+    return maximum;
+}
+
+Distribution QuantileSketch::summary() const {
+    Distribution distribution;
+    if (total == 0)
+        return distribution;
+    distribution.mean = sum / double(total);
+    distribution.p50 = quantile(0.50);
+    distribution.p95 = quantile(0.95);
+    distribution.p99 = quantile(0.99);
+    return distribution;
+}
+
+void MetricsRecorder::finish(const Process &process) {
+    int64_t turnaroundTime = process.finish_time - process.arrival_time;
+    turnaround.add(turnaroundTime);
+    waiting.add(turnaroundTime - process.burst);
+    response.add(process.start_time - process.arrival_time);
+
+    firstArrival = processes == 0 ? process.arrival_time : min(firstArrival, process.arrival_time);
+    lastFinish = processes == 0 ? process.finish_time : max(lastFinish, process.finish_time);
+    busy += double(process.burst);
+    processes++;
+}
+
+void MetricsRecorder::summarize(Metrics &metrics) const {
+    metrics.processes = processes;
+    metrics.turnaround = turnaround.summary();
+    metrics.waiting = waiting.summary();
+    metrics.response = response.summary();
+    int64_t span = lastFinish - firstArrival;
+    metrics.utilization = span > 0 ? busy / (double(cores) * double(span)) : 0;
+    metrics.context_switches = switches;
+}
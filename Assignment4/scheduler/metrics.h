@@ -0,0 +1,78 @@
+#pragma once
+
+#include "scheduler_ext.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Class that keeps a streaming summary of non-negative integers from which any quantile can be read back
+ * @note Log-linear histogram, every power of two is split into 128 buckets (values below 128 get a bucket each), so the memory is fixed no matter how many values are added and a quantile is off by less than 0.4% of its value
+ */
+class QuantileSketch {
+public:
+    QuantileSketch();
+
+    /**
+     * Function that adds a value to the sketch
+     * @param value - Value to add (negative values count as 0)
+     */
+    void add(int64_t value);
+
+    /**
+     * Function that returns the mean and the 50th, 95th and 99th percentiles of the values added so far
+     * @return Distribution - Summary of the values (all 0 if there are none)
+     */
+    Distribution summary() const;
+
+private:
+    // Number of values in every bucket
+    std::vector<int64_t> counts;
+
+    int64_t total = 0;
+    double sum = 0;
+    int64_t minimum = 0;
+    int64_t maximum = 0;
+
+    int64_t quantile(double fraction) const;
+};
+
+/**
+ * Class that collects the metrics of a simulation while it runs, shared by every CPU the simulation has
+ */
+class MetricsRecorder {
+public:
+    /**
+     * Constructor that sets up empty metrics
+     * @param cores - Number of CPUs the processes run on
+     */
+    explicit MetricsRecorder(int cores) : cores(cores) {}
+
+    /**
+     * Function that records the times of a process that is done
+     * @param process - Pointer to the process (start and finish times already set)
+     */
+    void finish(const Process &process);
+
+    /**
+     * Function that records that CPUs were handed from one process to another
+     * @param count - Number of switches
+     */
+    void contextSwitches(int64_t count) { switches += count; }
+
+    /**
+     * Function that writes the metrics collected so far
+     * @param metrics - Pointer to the metrics to fill in
+     */
+    void summarize(Metrics &metrics) const;
+
+private:
+    int cores;
+    QuantileSketch turnaround, waiting, response;
+    int64_t processes = 0;
+    int64_t switches = 0;
+
+    // Sum of the bursts, and the first arrival and last finish of the processes that are done
+    double busy = 0;
+    int64_t firstArrival = 0;
+    int64_t lastFinish = 0;
+};
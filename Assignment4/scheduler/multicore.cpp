@@ -0,0 +1,165 @@
+#include "multicore.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+MultiCoreSimulation::MultiCoreSimulation(const MultiCoreOptions &options, int64_t max_seq_len,
+                                         vector<Process> &processes, vector<vector<int>> &seqs,
+                                         MetricsRecorder *recorder)
+    : options(options), processes(processes), cores(options.cores), lastCore(processes.size(), -1),
+      processesRemaining(int(processes.size())) {
+    seqs.assign(options.cores, vector<int>());
+    schedules.reserve(options.cores);
+    for (auto &seq : seqs)
+        schedules.emplace_back(max_seq_len, processes, seq, recorder);
+}
+
+/**
+ * Function that returns the arrival time of the next process that has not arrived yet
+ * @return int64_t - Arrival time (the largest time if there is none)
+ */
+int64_t MultiCoreSimulation::nextArrival() const {
+    return processesArrived < int(processes.size()) ? processes[processesArrived].arrival_time
+                                                    : numeric_limits<int64_t>::max();
+}
+
+void MultiCoreSimulation::run() {
+    // Handles the earliest event until every process is done, slices that end at the same time as an arrival are handled first
+    while (processesRemaining > 0) {
+        if (!events.empty() && events.top().first <= nextArrival()) {
+            pair<int64_t, int> event = events.top();
+            events.pop();
+            endSlice(event.second, event.first);
+        } else
+            arrive(nextArrival());
+    }
+}
+
+/**
+ * Function that places the next process on a core when it arrives
+ * @param time - Arrival time of the process
+ */
+void MultiCoreSimulation::arrive(int64_t time) {
+    int id = processesArrived++;
+
+    // Picks the core, either by id or the one with the fewest processes (the lowest index on ties)
+    int target = id % options.cores;
+    if (options.balancing == Balancing::LeastLoaded) {
+        auto load = [&](int core) { return cores[core].queue.size() + (cores[core].running != -1); };
+        for (int core = 0; core < options.cores; core++)
+            if (load(core) < load(target) || (load(core) == load(target) && core < target))
+                target = core;
+    }
+    cores[target].queue.push(id, processes[id].burst);
+    cores[target].work += processes[id].burst;
+    if (cores[target].running == -1) {
+        dispatch(target, time);
+        return;
+    }
+
+    // A core that ran out of work takes the new waiting process (or another one) right away
+    if (options.balancing == Balancing::WorkStealing)
+        for (int core = 0; core < options.cores; core++)
+            if (cores[core].running == -1) {
+                if (steal(core))
+                    dispatch(core, time);
+                break;
+            }
+}
+
+/**
+ * Function that takes a process off its core at the end of its slice, and puts the next one on the core
+ * @param core - Index of the core
+ * @param time - End of the slice
+ */
+void MultiCoreSimulation::endSlice(int core, int64_t time) {
+    Core &state = cores[core];
+    int id = state.running;
+    int64_t ran = state.sliceEnd - state.sliceStart;
+    int64_t remaining = state.runningRemaining - ran;
+    state.work -= ran;
+    state.running = -1;
+
+    // Processes that arrived during the slice are already queued in front of the preempted process
+    if (remaining == 0) {
+        schedules[core].finish(id, time);
+        processesRemaining--;
+    } else
+        state.queue.push(id, remaining);
+    dispatch(core, time);
+}
+
+/**
+ * Function that moves the most recently queued process of the core with the most waiting processes to an idle core
+ * @param core - Index of the idle core
+ * @return bool - True if a process was moved
+ */
+bool MultiCoreSimulation::steal(int core) {
+    int victim = -1;
+    for (int other = 0; other < options.cores; other++)
+        if (other != core && !cores[other].queue.empty()
+            && (victim == -1 || cores[other].queue.size() > cores[victim].queue.size()))
+            victim = other;
+    if (victim == -1)
+        return false;
+    pair<int, int64_t> stolen = cores[victim].queue.popBack();
+    cores[victim].work -= stolen.second;
+    cores[core].queue.push(stolen.first, stolen.second);
+    cores[core].work += stolen.second;
+    return true;
+}
+
+/**
+ * Function that puts the process at the front of a core's queue on the core, after the switch (and migration) cost
+ * @param core - Index of the core
+ * @param time - Time the core becomes free
+ */
+void MultiCoreSimulation::dispatch(int core, int64_t time) {
+    Core &state = cores[core];
+    if (state.queue.empty() && !(options.balancing == Balancing::WorkStealing && steal(core))) {
+        state.idleSince = time;
+        return;
+    }
+
+    // Records the time the core was idle for (if any)
+    if (state.idleSince != -1 && state.idleSince < time)
+        schedules[core].idle();
+    state.idleSince = -1;
+    skipRounds(core, time);
+
+    pair<int, int64_t> next = state.queue.pop();
+    int64_t cost = 0;
+    if (next.first != schedules[core].last())
+        cost += options.switch_cost;
+    if (lastCore[next.first] != -1 && lastCore[next.first] != core)
+        cost += options.migration_cost;
+
+    schedules[core].run(next.first, time + cost);
+
+    state.running = next.first;
+    state.runningRemaining = next.second;
+    state.busySince = time;
+    state.sliceStart = time + cost;
+    state.sliceEnd = state.sliceStart + min(options.quantum, next.second);
+    lastCore[next.first] = core;
+    events.push(make_pair(state.sliceEnd, core));
+}
+
+/**
+ * Function that runs the processes in a core's queue ahead by as many slices as possible in one step
+ * @note The queue leaves every process it does not know yet (one that arrived or was stolen, it may have a migration cost) to dispatch(), so a skipped slot is always the switch cost and a slice. The slots must end by the next arrival, and with work stealing and waiting processes also before any other busy core can run out of work (the earliest is when it only finishes what it has now), since both could change the queue
+ * @param core - Index of the core
+ * @param time - Pointer to the time the core becomes free, moved to the end of the skipped slots
+ */
+void MultiCoreSimulation::skipRounds(int core, int64_t &time) {
+    Core &state = cores[core];
+
+    // Nothing can be stolen from a single process that stays on the core, and an idle core only steals when a process arrives
+    int64_t limit = nextArrival();
+    if (options.balancing == Balancing::WorkStealing && state.queue.size() > 1)
+        for (int other = 0; other < options.cores; other++)
+            if (other != core && cores[other].running != -1)
+                limit = min(limit, cores[other].busySince + cores[other].work - 1);
+    state.work -= state.queue.skip(options.quantum, options.switch_cost, time, limit, schedules[core]);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "metrics.h"
+#include "policies.h"
+#include "scheduler_ext.h"
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/**
+ * Class that simulates round robin on several cores, each with its own ready queue
+ * @note Event driven, the only events are arrivals and the ends of slices, kept in a heap ordered by time (cores with the same time in core order). A core whose queue nothing else can touch for a while skips over slices of it in one step, ahead of the other cores
+ */
+class MultiCoreSimulation {
+public:
+    /**
+     * Constructor that sets up idle cores
+     * @param options - Number of cores, quantum, balancing and costs
+     * @param max_seq_len - Maximum length of the schedule of every core
+     * @param processes - Pointer to the processes to simulate (sorted by arrival time)
+     * @param seqs - Pointer to the schedules, one per core
+     * @param recorder - Pointer to the metrics every core records into (nullptr = none)
+     */
+    MultiCoreSimulation(const MultiCoreOptions &options, int64_t max_seq_len, std::vector<Process> &processes,
+                        std::vector<std::vector<int>> &seqs, MetricsRecorder *recorder = nullptr);
+
+    /**
+     * Function that runs the simulation until every process is done
+     */
+    void run();
+
+private:
+    // Custom data struct that stores the state of one core
+    struct Core {
+        // Process id and remaining time of every waiting process
+        RoundRobinQueue queue;
+
+        // Process on the core (-1 = idle), its remaining time when it was put on the core and the part of the time line it runs in
+        int running = -1;
+        int64_t runningRemaining = 0;
+        int64_t sliceStart = 0;
+        int64_t sliceEnd = 0;
+
+        // Time the current slice was handed out at (before the switch) and the time the core has been idle since (-1 = busy)
+        int64_t busySince = 0;
+        int64_t idleSince = 0;
+
+        // Remaining time of every process on the core, waiting or running
+        int64_t work = 0;
+    };
+
+    MultiCoreOptions options;
+    std::vector<Process> &processes;
+    std::vector<Core> cores;
+    std::vector<Schedule> schedules;
+
+    // Core every process last ran on (-1 = none yet)
+    std::vector<int> lastCore;
+
+    // Ends of the slices that are running, the earliest on top
+    std::priority_queue<std::pair<int64_t, int>, std::vector<std::pair<int64_t, int>>,
+                        std::greater<std::pair<int64_t, int>>> events;
+
+    int processesArrived = 0;
+    int processesRemaining = 0;
+
+    int64_t nextArrival() const;
+
+    void arrive(int64_t time);
+
+    void endSlice(int core, int64_t time);
+
+    void dispatch(int core, int64_t time);
+
+    bool steal(int core);
+
+    void skipRounds(int core, int64_t &time);
+};
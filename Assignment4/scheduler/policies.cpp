@@ -0,0 +1,341 @@
+#include "policies.h"
+#include <algorithm>
+
+using namespace std;
+
+Schedule::Schedule(int64_t max_seq_len, vector<Process> &processes, vector<int> &seq, MetricsRecorder *recorder)
+    : max_seq_len(max_seq_len), processes(processes), seq(seq), recorder(recorder) {
+    seq.clear();
+}
+
+void Schedule::run(int id, int64_t time) {
+    if (processes[id].start_time == -1)
+        processes[id].start_time = time;
+    if (recorder && lastRun != -1 && lastRun != id)
+        recorder->contextSwitches(1);
+    lastRun = id;
+    add(id);
+}
+
+void Schedule::finish(int id, int64_t time) {
+    processes[id].finish_time = time;
+    if (recorder)
+        recorder->finish(processes[id]);
+}
+
+/**
+ * Function that adds a process id to the condensed schedule (repeated ids are merged and nothing is added once the schedule is full)
+ * @param id - Process id to add (-1 = idle)
+ */
+void Schedule::add(int id) {
+    if ((seq.empty() || seq.back() != id) && int64_t(seq.size()) < max_seq_len)
+        seq.push_back(id);
+}
+
+void Schedule::runSkipped(int64_t slots, int last) {
+    if (recorder)
+        recorder->contextSwitches(slots);
+    lastRun = last;
+}
+
+void RoundRobinQueue::push(int id, int64_t remaining) {
+    int node;
+    if (freeNodes.empty()) {
+        node = int(nodes.size());
+        nodes.emplace_back();
+    } else {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+        nodes[node] = Node();
+    }
+
+    // Xorshift, any spread of the priorities keeps the treap balanced
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    nodes[node].id = id;
+    nodes[node].priority = seed;
+    nodes[node].known = id == lastPopped;
+    nodes[node].unknown = !nodes[node].known;
+    nodes[node].remaining = remaining;
+    nodes[node].shortest = remaining;
+    root = merge(root, node);
+}
+
+pair<int, int64_t> RoundRobinQueue::pop() {
+    int front, rest;
+    split(root, 1, front, rest);
+    root = rest;
+    lastPopped = nodes[front].id;
+    return make_pair(nodes[front].id, nodes[release(front)].remaining);
+}
+
+pair<int, int64_t> RoundRobinQueue::popBack() {
+    int rest, back;
+    split(root, size() - 1, rest, back);
+    root = rest;
+    return make_pair(nodes[back].id, nodes[release(back)].remaining);
+}
+
+int64_t RoundRobinQueue::skip(int64_t quantum, int64_t switchCost, int64_t &time, int64_t limit, Schedule &schedule) {
+    if (root == -1 || limit <= time)
+        return 0;
+    int64_t size = nodes[root].size;
+    int64_t slot = (size > 1 ? switchCost : 0) + quantum;
+
+    // The process at the front has to take a regular slot as well, it has no switch cost if it ran last (unless it is the only one)
+    if ((idAt(0) != schedule.last() ? switchCost : 0) != slot - quantum)
+        return 0;
+
+    // Skips whole rounds, the order of the queue is the same after every round
+    int64_t ran = 0;
+    if (nodes[root].unknown == 0 && nodes[root].shortest > quantum) {
+        int64_t rounds = min((nodes[root].shortest - 1) / quantum, (limit - time) / slot / size);
+        if (rounds > 0) {
+            record(rounds * size, slot, quantum, time, schedule);
+            apply(root, rounds * quantum);
+            ran += rounds * quantum * size;
+            time += rounds * slot * size;
+        }
+    }
+
+    // Runs the processes in front of the first one that has to run on its own for one slice each and moves them to the back
+    int64_t count = min(firstStop(quantum), (limit - time) / slot);
+    if (count > 0) {
+        record(count, slot, quantum, time, schedule);
+        int front, rest;
+        split(root, count, front, rest);
+        apply(front, quantum);
+        root = merge(rest, front);
+        ran += count * quantum;
+        time += count * slot;
+    }
+    return ran;
+}
+
+/**
+ * Function that takes time off every process in a subtree
+ * @param node - Root of the subtree (-1 = empty)
+ * @param time - Time to take off
+ */
+void RoundRobinQueue::apply(int node, int64_t time) {
+    if (node == -1)
+        return;
+    nodes[node].remaining -= time;
+    nodes[node].shortest -= time;
+    nodes[node].pending += time;
+}
+
+/**
+ * Function that hands the time still to take off the children of a node down to them
+ * @param node - Index of the node
+ */
+void RoundRobinQueue::pushDown(int node) {
+    if (nodes[node].pending == 0)
+        return;
+    apply(nodes[node].left, nodes[node].pending);
+    apply(nodes[node].right, nodes[node].pending);
+    nodes[node].pending = 0;
+}
+
+/**
+ * Function that recomputes the summary of a subtree from its children
+ * @param node - Index of the node
+ */
+void RoundRobinQueue::update(int node) {
+    Node &state = nodes[node];
+    state.size = 1;
+    state.unknown = !state.known;
+    state.shortest = state.remaining;
+    for (int child : {state.left, state.right})
+        if (child != -1) {
+            state.size += nodes[child].size;
+            state.unknown += nodes[child].unknown;
+            state.shortest = min(state.shortest, nodes[child].shortest);
+        }
+}
+/**
+ * Function that joins two treaps, every process of the first one ends up in front of the second one
+ * @param left - Root of the first treap (-1 = empty)
+ * @param right - Root of the second treap (-1 = empty)
+ * @return int - Root of the joined treap
+ */
+int RoundRobinQueue::merge(int left, int right) {
+    if (left == -1 || right == -1)
+        return left == -1 ? right : left;
+    if (nodes[left].priority > nodes[right].priority) {
+        pushDown(left);
+        nodes[left].right = merge(nodes[left].right, right);
+        update(left);
+        return left;
+    }
+    pushDown(right);
+    nodes[right].left = merge(left, nodes[right].left);
+    update(right);
+    return right;
+}
+
+/**
+ * Function that splits a treap after its first processes
+ * @param node - Root of the treap (-1 = empty)
+ * @param count - Number of processes that go into the first part
+ * @param left - Pointer to the root of the first part
+ * @param right - Pointer to the root of the rest
+ */
+void RoundRobinQueue::split(int node, int64_t count, int &left, int &right) {
+    if (node == -1) {
+        left = right = -1;
+        return;
+    }
+    pushDown(node);
+    int64_t leftSize = nodes[node].left == -1 ? 0 : nodes[nodes[node].left].size;
+    if (count <= leftSize) {
+        split(nodes[node].left, count, left, nodes[node].left);
+        right = node;
+    } else {
+        split(nodes[node].right, count - leftSize - 1, nodes[node].right, right);
+        left = node;
+    }
+    update(node);
+}
+
+/**
+ * Function that hands the node of a process that left the queue back for reuse
+ * @param node - Index of the node (split off on its own)
+ * @return int - Index of the node, still readable until the next push
+ */
+int RoundRobinQueue::release(int node) {
+    freeNodes.push_back(node);
+    return node;
+}
+
+/**
+ * Function that returns the process at a position of the queue
+ * @param index - Position (0 = front)
+ * @return int - Id of the process
+ */
+int RoundRobinQueue::idAt(int64_t index) const {
+    int node = root;
+    while (true) {
+        int64_t leftSize = nodes[node].left == -1 ? 0 : nodes[nodes[node].left].size;
+        if (index == leftSize)
+            return nodes[node].id;
+        if (index < leftSize)
+            node = nodes[node].left;
+        else {
+            index -= leftSize + 1;
+            node = nodes[node].right;
+        }
+    }
+}
+
+/**
+ * Function that returns the position of the first process that cannot be skipped over, because it would finish in its next slice or the queue does not know it
+ * @param quantum - Time slice length
+ * @return int64_t - Position of the process (the size of the queue if there is none)
+ */
+int64_t RoundRobinQueue::firstStop(int64_t quantum) {
+    auto stops = [&](int node) { return node != -1 && (nodes[node].unknown > 0 || nodes[node].shortest <= quantum); };
+    int64_t index = 0;
+    int node = root;
+    while (node != -1) {
+        pushDown(node);
+        int left = nodes[node].left;
+        if (stops(left)) {
+            node = left;
+            continue;
+        }
+        index += left == -1 ? 0 : nodes[left].size;
+        if (!nodes[node].known || nodes[node].remaining <= quantum)
+            return index;
+        index++;
+        node = nodes[node].right;
+    }
+    return index;
+}
+
+/**
+ * Function that records the slots of a skip, they go through the queue from the front and start over at the front after the back
+ * @note Only the slots that still add to the schedule go through Schedule::run(), the others are counted at once. Every process of the queue has started already
+ * @param slots - Number of slots
+ * @param slot - Length of a slot
+ * @param quantum - Time slice length (the rest of a slot is the switch before it)
+ * @param time - Time the first slot starts at
+ * @param schedule - Pointer to the schedule
+ */
+void RoundRobinQueue::record(int64_t slots, int64_t slot, int64_t quantum, int64_t time, Schedule &schedule) const {
+    // A single process stays on the CPU after its first slot
+    int64_t size = nodes[root].size;
+    if (size == 1) {
+        schedule.run(idAt(0), time + slot - quantum);
+        return;
+    }
+    int64_t index = 0;
+    for (; index < slots && schedule.growing(); index++)
+        schedule.run(idAt(index % size), time + index * slot + slot - quantum);
+    if (index < slots)
+        schedule.runSkipped(slots - index, idAt((slots - 1) % size));
+}
+
+pair<int, int64_t> FcfsPolicy::next() {
+    pair<int, int64_t> front = queue.front();
+    queue.pop_front();
+    return front;
+}
+
+pair<int, int64_t> ShortestFirstPolicy::next() {
+    pair<int64_t, int> top = heap.top();
+    heap.pop();
+    return make_pair(top.second, top.first);
+}
+
+void PriorityPolicy::add(int id, int64_t remaining, int64_t time, bool) {
+    int64_t priority = id < int(priorities.size()) ? priorities[id] : 0;
+    __int128 aged = aging > 0 ? __int128(priority) * aging + time : priority;
+    heap.push(make_tuple(aged, time, id, remaining));
+}
+
+pair<int, int64_t> PriorityPolicy::next() {
+    Entry top = heap.top();
+    heap.pop();
+    return make_pair(get<2>(top), get<3>(top));
+}
+
+MlfqPolicy::MlfqPolicy(int64_t quantum, int levels, int processCount)
+    : queues(levels), quanta(levels), level(processCount, 0) {
+    // Doubles the slice for every level (stops at the largest time instead of overflowing)
+    quanta[0] = quantum;
+    for (int index = 1; index < levels; index++)
+        quanta[index] = quanta[index - 1] > numeric_limits<int64_t>::max() / 2 ? numeric_limits<int64_t>::max()
+                                                                             : quanta[index - 1] * 2;
+}
+
+void MlfqPolicy::add(int id, int64_t remaining, int64_t, bool usedSlice) {
+    // A process that used up its whole slice drops one level, one that was preempted stays where it is
+    if (usedSlice && level[id] + 1 < int(queues.size()))
+        level[id]++;
+    queues[level[id]].push(id, remaining);
+}
+
+bool MlfqPolicy::empty() const {
+    for (auto &queue : queues)
+        if (!queue.empty())
+            return false;
+    return true;
+}
+
+pair<int, int64_t> MlfqPolicy::next() {
+    for (auto &queue : queues)
+        if (!queue.empty())
+            return queue.pop();
+    return make_pair(-1, int64_t(0));
+}
+
+void MlfqPolicy::skip(int64_t &time, int64_t nextArrival, Schedule &schedule) {
+    // Only the bottom level keeps every process in the same queue after its slice, the levels above it have to be empty
+    for (size_t index = 0; index + 1 < queues.size(); index++)
+        if (!queues[index].empty())
+            return;
+    queues.back().skip(quanta.back(), 0, time, nextArrival, schedule);
+}
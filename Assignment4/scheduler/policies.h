@@ -0,0 +1,362 @@
+#pragma once
+
+#include "metrics.h"
+#include "scheduler_ext.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * Class that records the result of a simulation, the start and finish times of the processes and the condensed schedule
+ */
+class Schedule {
+public:
+    /**
+     * Constructor that clears any pre-existing entries in the schedule
+     * @param max_seq_len - Maximum length of the schedule
+     * @param processes - Pointer to the processes whose start and finish times are set
+     * @param seq - Pointer to the schedule
+     * @param recorder - Pointer to the metrics to record into (nullptr = none)
+     */
+    Schedule(int64_t max_seq_len, std::vector<Process> &processes, std::vector<int> &seq,
+             MetricsRecorder *recorder = nullptr);
+
+    /**
+     * Function that records that a process is put on the CPU (repeated ids are merged in the schedule)
+     * @param id - Id of the process
+     * @param time - Time the process is put on the CPU at
+     */
+    void run(int id, int64_t time);
+
+    /**
+     * Function that checks whether putting another process on the CPU can still add to the schedule
+     * @return bool - True if the schedule is not full
+     */
+    bool growing() const { return int64_t(seq.size()) < max_seq_len; }
+
+    /**
+     * Function that records slots that are skipped over without calling run(), every one of them puts another process on the CPU than the one before
+     * @param slots - Number of slots
+     * @param last - Id of the process in the last slot
+     */
+    void runSkipped(int64_t slots, int last);
+
+    /**
+     * Function that returns the last process put on the CPU
+     * @return int - Id of the process (-1 = none yet)
+     */
+    int last() const { return lastRun; }
+
+    /**
+     * Function that records that the CPU is idle
+     */
+    void idle() { add(-1); }
+
+    /**
+     * Function that records that a process is done
+     * @param id - Id of the process
+     * @param time - Time the process finished at
+     */
+    void finish(int id, int64_t time);
+
+private:
+    int64_t max_seq_len;
+    std::vector<Process> &processes;
+    std::vector<int> &seq;
+    MetricsRecorder *recorder;
+
+    // Last process put on the CPU (-1 = none yet)
+    int lastRun = -1;
+
+    void add(int id);
+};
+
+/**
+ * Class that decides which ready process gets the CPU, simulate_policy() runs the same event driven loop for every policy and only asks the policy for its decisions
+ */
+class SchedulingPolicy {
+public:
+    virtual ~SchedulingPolicy() = default;
+
+    /**
+     * Function that adds a process to the ready processes, either because it arrived or because it was taken off the CPU
+     * @param id - Id of the process
+     * @param remaining - Time the process still needs on the CPU
+     * @param time - Current time
+     * @param usedSlice - True if the process was taken off the CPU because its whole slice was used up
+     */
+    virtual void add(int id, int64_t remaining, int64_t time, bool usedSlice) = 0;
+
+    /**
+     * Function that checks whether there are no ready processes
+     * @return bool - True if there are none
+     */
+    virtual bool empty() const = 0;
+
+    /**
+     * Function that removes the ready process that runs next
+     * @return pair - Id of the process and the time it still needs on the CPU
+     */
+    virtual std::pair<int, int64_t> next() = 0;
+
+    /**
+     * Function that returns how long a process may run before it is taken off the CPU (without counting arrivals)
+     * @param id - Id of the process
+     * @return int64_t - Length of the slice (the largest time if it runs until it is done)
+     */
+    virtual int64_t slice(int id) const {
+        (void)id;
+        return std::numeric_limits<int64_t>::max();
+    }
+
+    /**
+     * Function that checks whether an arriving process takes the CPU away from the running one
+     * @param running - Id of the running process
+     * @param runningRemaining - Time the running process still needs at the arrival
+     * @param arriving - Id of the arriving process
+     * @return bool - True if the running process is taken off the CPU at the arrival
+     */
+    virtual bool preempts(int running, int64_t runningRemaining, int arriving) const {
+        (void)running, (void)runningRemaining, (void)arriving;
+        return false;
+    }
+
+    /**
+     * Function that is called before every decision and may run the ready processes ahead in time in one step, as long as no decision before nextArrival would differ from the ones made one by one
+     * @param time - Pointer to the current time, moved past the skipped work
+     * @param nextArrival - Arrival time of the next process that has not arrived yet
+     * @param schedule - Pointer to the schedule the skipped work is recorded in
+     */
+    virtual void skip(int64_t &time, int64_t nextArrival, Schedule &schedule) {
+        (void)time, (void)nextArrival, (void)schedule;
+    }
+};
+
+/**
+ * Class that stores a round robin ready queue and can run the processes at its front ahead by any number of slices in one step
+ * @note The queue is a treap ordered by position. Every node keeps the size, the shortest remaining time and the number of processes the queue does not know yet of its subtree, and time taken off a whole subtree is stored in its root and handed down lazily. Whole rounds take the time off the root, and the slices of a prefix are a split, the time taken off the prefix and a merge that moves it to the back, so a skip costs O(log n) no matter how many slices it passes over
+ */
+class RoundRobinQueue {
+public:
+    /**
+     * Function that adds a process to the back of the queue
+     * @note Only the process that was taken off the queue last is known to it, any other one (an arrival, a process that comes from another queue or another CPU) has to run one slice on its own before it can be skipped over, since it may not have started yet or may come with a migration cost
+     * @param id - Id of the process
+     * @param remaining - Time the process still needs on the CPU
+     */
+    void push(int id, int64_t remaining);
+
+    /**
+     * Function that removes the process at the front of the queue
+     * @return pair - Id of the process and the time it still needs on the CPU
+     */
+    std::pair<int, int64_t> pop();
+
+    /**
+     * Function that removes the process at the back of the queue (the one added last)
+     * @return pair - Id of the process and the time it still needs on the CPU
+     */
+    std::pair<int, int64_t> popBack();
+
+    bool empty() const { return root == -1; }
+
+    int64_t size() const { return root == -1 ? 0 : nodes[root].size; }
+
+    /**
+     * Function that runs the processes at the front of the queue ahead by as many slots as possible in one step
+     * @note A slot is the switch cost (only when there is more than one process) followed by a whole slice. Whole rounds are skipped first, as long as every process keeps at least one unit of work, then the slots up to the first process that would finish, that the queue does not know or whose slot would end after the limit. That process is left at the front for the caller to run on its own, so the queue keeps its size
+     * @param quantum - Time slice length
+     * @param switchCost - Time it takes to put another process on the CPU
+     * @param time - Pointer to the current time, moved to the end of the skipped slots
+     * @param limit - Time every skipped slot has to end by
+     * @param schedule - Pointer to the schedule the skipped slots are recorded in
+     * @return int64_t - CPU time taken off the processes
+     */
+    int64_t skip(int64_t quantum, int64_t switchCost, int64_t &time, int64_t limit, Schedule &schedule);
+
+private:
+    // Custom data struct that stores one process in the treap
+    struct Node {
+        int id;
+        uint32_t priority;
+        int left = -1;
+        int right = -1;
+
+        // Whether the queue knows the process, and the number of processes and of processes it does not know in the subtree
+        bool known;
+        int size = 1;
+        int unknown;
+
+        // Remaining time of the process, shortest remaining time in the subtree and time still to take off the children
+        int64_t remaining;
+        int64_t shortest;
+        int64_t pending = 0;
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> freeNodes;
+    int root = -1;
+
+    // Last process taken off the front and the state of the generator for the priorities
+    int lastPopped = -1;
+    uint32_t seed = 2463534242u;
+
+    void apply(int node, int64_t time);
+
+    void pushDown(int node);
+
+    void update(int node);
+
+    int merge(int left, int right);
+
+    void split(int node, int64_t count, int &left, int &right);
+
+    int release(int node);
+
+    int idAt(int64_t index) const;
+
+    int64_t firstStop(int64_t quantum);
+
+    void record(int64_t slots, int64_t slot, int64_t quantum, int64_t time, Schedule &schedule) const;
+};
+
+/**
+ * Class for round robin, every process runs for at most one slice before it goes to the back of the queue
+ */
+class RoundRobinPolicy : public SchedulingPolicy {
+public:
+    explicit RoundRobinPolicy(int64_t quantum) : quantum(quantum) {}
+
+    void add(int id, int64_t remaining, int64_t, bool) override { queue.push(id, remaining); }
+
+    bool empty() const override { return queue.empty(); }
+
+    std::pair<int, int64_t> next() override { return queue.pop(); }
+
+    int64_t slice(int) const override { return quantum; }
+
+    void skip(int64_t &time, int64_t nextArrival, Schedule &schedule) override {
+        queue.skip(quantum, 0, time, nextArrival, schedule);
+    }
+
+private:
+    int64_t quantum;
+    RoundRobinQueue queue;
+};
+
+/**
+ * Class for first come first served, every process runs until it is done in the order they arrived
+ */
+class FcfsPolicy : public SchedulingPolicy {
+public:
+    void add(int id, int64_t remaining, int64_t, bool) override { queue.push_back(std::make_pair(id, remaining)); }
+
+    bool empty() const override { return queue.empty(); }
+
+    std::pair<int, int64_t> next() override;
+
+private:
+    std::deque<std::pair<int, int64_t>> queue;
+};
+
+/**
+ * Class for shortest job first and shortest remaining time first, the ready process that needs the least time runs next (ties go to the process that arrived first)
+ * @note Keeps the ready processes in a binary heap, every decision takes O(log n)
+ */
+class ShortestFirstPolicy : public SchedulingPolicy {
+public:
+    /**
+     * Constructor for either of the two policies
+     * @param preemptive - True for shortest remaining time first (an arrival that needs less time than the running process is left with takes the CPU)
+     * @param processes - Pointer to the simulated processes
+     */
+    ShortestFirstPolicy(bool preemptive, const std::vector<Process> &processes)
+        : preemptive(preemptive), processes(processes) {}
+
+    void add(int id, int64_t remaining, int64_t, bool) override { heap.push(std::make_pair(remaining, id)); }
+
+    bool empty() const override { return heap.empty(); }
+
+    std::pair<int, int64_t> next() override;
+
+    bool preempts(int, int64_t runningRemaining, int arriving) const override {
+        return preemptive && processes[arriving].burst < runningRemaining;
+    }
+
+private:
+    bool preemptive;
+    const std::vector<Process> &processes;
+
+    // Remaining time and id of every ready process, the smallest on top
+    std::priority_queue<std::pair<int64_t, int>, std::vector<std::pair<int64_t, int>>,
+                        std::greater<std::pair<int64_t, int>>> heap;
+};
+
+/**
+ * Class for non-preemptive priority scheduling with aging
+ * @note A process that waits since time s with priority p is ahead of one that waits since time s' with priority p' if p * aging + s < p' * aging + s', ties go to the one that became ready first (aging is continuous: every time unit of waiting is worth 1 / aging of a priority level, it does not move in whole levels). The keys are kept in 128 bits so the product cannot overflow. Both sides grow with the current time at the same rate, so the order of the waiting processes never changes and they can stay in a binary heap
+ */
+class PriorityPolicy : public SchedulingPolicy {
+public:
+    /**
+     * Constructor that sets up the policy
+     * @param aging - Waiting time worth one priority level (0 = no aging)
+     * @param priorities - Pointer to the priority of every process by id (processes without an entry have priority 0)
+     */
+    PriorityPolicy(int64_t aging, const std::vector<int64_t> &priorities)
+        : aging(aging), priorities(priorities) {}
+
+    void add(int id, int64_t remaining, int64_t time, bool) override;
+
+    bool empty() const override { return heap.empty(); }
+
+    std::pair<int, int64_t> next() override;
+
+private:
+    int64_t aging;
+    const std::vector<int64_t> &priorities;
+
+    // Aged priority, time it became ready, id and remaining time of every ready process, the smallest on top
+    using Entry = std::tuple<__int128, int64_t, int, int64_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+};
+
+/**
+ * Class for multi-level feedback queues, every level is a round robin queue whose slice is twice as long as the one of the level above
+ * @note The bottom level is skipped over like round robin once the levels above it are empty
+ */
+class MlfqPolicy : public SchedulingPolicy {
+public:
+    /**
+     * Constructor that sets up the levels
+     * @param quantum - Time slice of the top level
+     * @param levels - Number of levels
+     * @param processCount - Number of simulated processes
+     */
+    MlfqPolicy(int64_t quantum, int levels, int processCount);
+
+    void add(int id, int64_t remaining, int64_t time, bool usedSlice) override;
+
+    bool empty() const override;
+
+    std::pair<int, int64_t> next() override;
+
+    int64_t slice(int id) const override { return quanta[level[id]]; }
+
+    bool preempts(int running, int64_t, int) const override { return level[running] > 0; }
+
+    void skip(int64_t &time, int64_t nextArrival, Schedule &schedule) override;
+
+private:
+    // Ready queue and time slice of every level, the top level first
+    std::vector<RoundRobinQueue> queues;
+    std::vector<int64_t> quanta;
+
+    // Level every process is in
+    std::vector<int> level;
+};
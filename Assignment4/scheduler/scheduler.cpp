@@ -1,177 +1,178 @@
-#include "scheduler.h"
+#include "scheduler_ext.h"
 #include "common.h"
-#include <queue>
+#include "metrics.h"
+#include "multicore.h"
+#include "policies.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
 
 using namespace std;
 
 /**
- * Function that uses the provided processes vector and schedules them in a round robin manner where quantum is the slice length
- * @note Implements code from scheduler (https://gitlab.com/cpsc457/public/scheduler) and Gabriela Wcislo's fcfsSimulationLoop.cpp from jun2_code
- * @param quantum - Time slice length before which a process is context switched off the CPU
+ * Function that runs the simulation loop shared by all the policies, the policy only decides which ready process runs next and for how long
+ * @note Event driven, time only moves from one decision to the next (a process finishing, using up its slice or being preempted by an arrival) and the policy may skip over work whose decisions are known in advance, so the runtime depends on the number of arrivals and completions instead of the simulated time. A process that is taken off the CPU goes back to the policy after the processes that arrived while it ran and before the ones that arrive right as it stops
+ * @param policy - Pointer to the policy that makes the decisions
  * @param max_seq_len - Number of sequences to return in the generated schedule (cuts off anything that occurs after this number)
- * @param processes - Pointer to a vector consisting of Process objects that will be scheduled
+ * @param processes - Pointer to a vector consisting of Process objects that will be scheduled (sorted by arrival time)
  * @param seq - Pointer to an integer vector that will contain the order that processes are scheduled in based on Process ID
+ * @param metrics - Pointer to the metrics to fill in (nullptr = none are collected)
  */
-void simulate_rr(
-        int64_t quantum,
+static void simulate(
+        SchedulingPolicy &policy,
         int64_t max_seq_len,
         std::vector<Process> &processes,
-        std::vector<int> &seq
+        std::vector<int> &seq,
+        Metrics *metrics
 ) {
-    // Clears any pre-existing entries in the schedule
-    seq.clear();
-
-    // Stores the process id of the process currently on the CPU (-1 = idle)
-    int currentProcessID = -1;
-
-    // Stores the remaining time left for the process to complete
-    int64_t remainingTime = 0;
-
-    // Creates a queue that will store each Process as a pair consisting of the process's id and remaining time
-    queue<pair<int, int64_t>> readyQueue;
+    // Only collects metrics when they are asked for
+    unique_ptr<MetricsRecorder> recorder(metrics ? new MetricsRecorder(1) : nullptr);
+    Schedule schedule(max_seq_len, processes, seq, recorder.get());
 
     // Stores the current time in the schedule
     int64_t currentTime = 0;
 
-    // Stores how many processes have arrived
+    // Stores how many processes have arrived and how many are remaining
     int processesArrived = 0;
-
-    // Stores how many processes are remaining
     int processesRemaining = int(processes.size());
 
-    // Stores the time that the current process time spent on the CPU
-    int64_t timeOnCPU = 0;
+    // Returns the arrival time of the next process that has not arrived yet (the largest time if there is none)
+    auto nextArrival = [&]() {
+        return processesArrived < int(processes.size()) ? processes[processesArrived].arrival_time
+                                                        : numeric_limits<int64_t>::max();
+    };
 
-    // Stores a boolean to keep track of when a time jump occurs to prevent incrementing the time for that iteration
-    bool jumpOccurred = false;
+    // Hands the next process that has not arrived yet to the policy
+    auto arrive = [&]() {
+        policy.add(processesArrived, processes[processesArrived].burst, processes[processesArrived].arrival_time, false);
+        processesArrived++;
+    };
 
     // Loops until all processes have been complete (scheduled)
-    while (true) {
-        // If there are no processes remaining then breaks the loop as we are done
-        if (processesRemaining == 0) break;
-
-        // Checks to see if current process on the CPU is done and replaces it with an idle process if it is
-        if (currentProcessID > -1 && remainingTime == 0) {
-            processes[currentProcessID].finish_time = currentTime;
-            currentProcessID = -1;
-            processesRemaining--;
-            timeOnCPU = 0;
-            continue;
-        }
-
-        // Checks to see if the current process on the CPU has exceeded the time slice allowed per process and adds it back to the ready queue if there is another process waiting (otherwise the current process is allowed to continue)
-        if (currentProcessID > -1 && timeOnCPU >= quantum && !readyQueue.empty()) {
-            readyQueue.push(make_pair(currentProcessID, remainingTime));
-            currentProcessID = -1;
-            timeOnCPU = 0;
+    while (processesRemaining > 0) {
+        // Adds every process that has arrived by now to the ready processes
+        while (nextArrival() <= currentTime)
+            arrive();
+
+        // Skips to the next arrival if the CPU is idle
+        if (policy.empty()) {
+            schedule.idle();
+            currentTime = nextArrival();
             continue;
         }
 
-        // Checks to see if there is an incoming process and adds it to the ready queue if it has arrived
-        if (!processes.empty() && processes[processesArrived].arrival_time == currentTime) {
-            if (currentProcessID > -1 && timeOnCPU >= quantum) {
-                readyQueue.push(make_pair(currentProcessID, remainingTime));
-                currentProcessID = -1;
-                timeOnCPU = 0;
+        // Lets the policy skip ahead and then puts the process it picks on the CPU
+        policy.skip(currentTime, nextArrival(), schedule);
+
+        // Skipped work can end right as processes arrive, they are ready before the pick (a new process goes ahead of the bottom level of MLFQ)
+        while (nextArrival() <= currentTime)
+            arrive();
+        pair<int, int64_t> current = policy.next();
+        schedule.run(current.first, currentTime);
+
+        // Runs the process until its slice is used up or it is done, unless an arrival before that takes the CPU away from it
+        int64_t slice = policy.slice(current.first);
+        int64_t stopTime = currentTime + min(slice, current.second);
+        bool usedSlice = slice < current.second;
+        while (nextArrival() < stopTime) {
+            if (policy.preempts(current.first, current.second - (nextArrival() - currentTime), processesArrived)) {
+                stopTime = nextArrival();
+                usedSlice = false;
+                break;
             }
-            readyQueue.push(make_pair(processesArrived, processes[processesArrived].burst));
-            processesArrived++;
-            continue;
-        }
-
-        // Checks to see if the CPU is idle and if there is a process at the front of the ready queue (has arrived) then allows the ready process to use the CPU
-        if (currentProcessID == -1 && !readyQueue.empty()) {
-            currentProcessID = readyQueue.front().first;
-            remainingTime = readyQueue.front().second;
-            readyQueue.pop();
-            timeOnCPU = 0;
-            if (processes[currentProcessID].start_time == -1)
-                processes[currentProcessID].start_time = currentTime;
-            continue;
+            arrive();
         }
-
-        // If the current process's remaining time is less than a quantum - time elapsed on CPU, then skips to either the arrival time of the next process or the end of the slice based on the smaller value (implements optimization hint 1)
-        if (currentProcessID > -1 && remainingTime <= abs(timeOnCPU - quantum)) {
-            if (abs(currentTime - processes[processesArrived].arrival_time) <= abs(timeOnCPU - quantum) &&
-                abs(currentTime - processes[processesArrived].arrival_time) <= remainingTime) {
-                remainingTime -= abs(currentTime - processes[processesArrived].arrival_time);
-                timeOnCPU += abs(currentTime - processes[processesArrived].arrival_time);
-                currentTime = processes[processesArrived].arrival_time;
-                if ((seq.empty() || seq.back() != currentProcessID) && int64_t(seq.size()) < max_seq_len)
-                    seq.push_back(currentProcessID);
-                jumpOccurred = true;
-                continue;
-            } else if (abs(currentTime - processes[processesArrived].arrival_time) <= abs(timeOnCPU - quantum) &&
-                       abs(currentTime - processes[processesArrived].arrival_time) > remainingTime) {
-                currentTime += remainingTime;
-                timeOnCPU += remainingTime;
-                remainingTime = 0;
-                if ((seq.empty() || seq.back() != currentProcessID) && int64_t(seq.size()) < max_seq_len)
-                    seq.push_back(currentProcessID);
-                jumpOccurred = true;
-                continue;
-            } else if (abs(currentTime - processes[processesArrived].arrival_time) > abs(timeOnCPU - quantum)) {
-                currentTime += remainingTime;
-                timeOnCPU += remainingTime;
-                remainingTime = 0;
-                if ((seq.empty() || seq.back() != currentProcessID) && int64_t(seq.size()) < max_seq_len)
-                    seq.push_back(currentProcessID);
-                jumpOccurred = true;
-                continue;
-            }
-        }
-
-        // If the current process is the last remaining process then skips to the process's end time (implements optimization hint 2)
-        if (currentProcessID > -1 && processesRemaining == 1) {
-            currentTime += remainingTime;
-            timeOnCPU += remainingTime;
-            remainingTime = 0;
-            if ((seq.empty() || seq.back() != currentProcessID) && int64_t(seq.size()) < max_seq_len)
-                seq.push_back(currentProcessID);
-            jumpOccurred = true;
-            continue;
-        }
-
-        // If the CPU is currently idle and there will be a process arriving in the future then skips to its arrival time (implements optimization hint 3)
-        if (currentProcessID == -1 && readyQueue.empty()) {
-            currentTime = processes[processesArrived].arrival_time;
-            if ((seq.empty() || seq.back() != currentProcessID) && int64_t(seq.size()) < max_seq_len)
-                seq.push_back(currentProcessID);
-            jumpOccurred = true;
+        current.second -= stopTime - currentTime;
+        currentTime = stopTime;
+        if (current.second == 0) {
+            schedule.finish(current.first, currentTime);
+            processesRemaining--;
             continue;
         }
+        policy.add(current.first, current.second, currentTime, usedSlice);
+    }
 
-        // If there is no processes waiting in the ready queue then skips either to the arrival time of the next process or the end time of the current process based on the smaller value (implements optimization hint 4)
-        if (currentProcessID > -1 && readyQueue.empty()) {
-            if (currentTime + remainingTime > processes[processesArrived].arrival_time) {
-                remainingTime -= abs(currentTime - processes[processesArrived].arrival_time);
-                timeOnCPU += abs(currentTime - processes[processesArrived].arrival_time);
-                currentTime = processes[processesArrived].arrival_time;
-                if ((seq.empty() || seq.back() != currentProcessID) && int64_t(seq.size()) < max_seq_len)
-                    seq.push_back(currentProcessID);
-                jumpOccurred = true;
-                continue;
-            } else if (currentTime + remainingTime <= processes[processesArrived].arrival_time) {
-                currentTime += remainingTime;
-                timeOnCPU += remainingTime;
-                remainingTime = 0;
-                if ((seq.empty() || seq.back() != currentProcessID) && int64_t(seq.size()) < max_seq_len)
-                    seq.push_back(currentProcessID);
-                jumpOccurred = true;
-                continue;
-            }
-        }
+    if (recorder)
+        recorder->summarize(*metrics);
+}
 
-        // Adds to the schedule sequence if necessary (is a condensed schedule that doesn't exceed the length specified by the calling code)
-        if ((seq.empty() || seq.back() != currentProcessID) && int64_t(seq.size()) < max_seq_len)
-            seq.push_back(currentProcessID);
+/**
+ * Function that uses the provided processes vector and schedules them in a round robin manner where quantum is the slice length
+ * @note Implements code from scheduler (https://gitlab.com/cpsc457/public/scheduler) and Gabriela Wcislo's fcfsSimulationLoop.cpp from jun2_code
+ * @note Slices are skipped over in one step, whole rounds and then the ones up to the next completion, as long as no arrival falls into them. A process that is preempted goes back into the ready queue before the processes that arrive at the same time
+ * @param quantum - Time slice length before which a process is context switched off the CPU
+ * @param max_seq_len - Number of sequences to return in the generated schedule (cuts off anything that occurs after this number)
+ * @param processes - Pointer to a vector consisting of Process objects that will be scheduled (sorted by arrival time)
+ * @param seq - Pointer to an integer vector that will contain the order that processes are scheduled in based on Process ID
+ */
+void simulate_rr(
+        int64_t quantum,
+        int64_t max_seq_len,
+        std::vector<Process> &processes,
+        std::vector<int> &seq
+) {
+    RoundRobinPolicy policy(quantum);
+    simulate(policy, max_seq_len, processes, seq, nullptr);
+}
 
-        // Performs work (decrements the process's remaining time) and increments the time spent on the CPU if a jump hasn't occurred this run
-        if (!jumpOccurred) {
-            if (remainingTime > 0) remainingTime--;
-            currentTime++;
-            timeOnCPU++;
-        } else
-            jumpOccurred = false;
+/**
+ * Function that schedules the processes under the chosen policy
+ * @param policy - Policy to schedule with
+ * @param options - Parameters of the policy (quantum for round robin and MLFQ, aging and priorities for priority, levels for MLFQ)
+ * @param max_seq_len - Number of sequences to return in the generated schedule (cuts off anything that occurs after this number)
+ * @param processes - Pointer to a vector consisting of Process objects that will be scheduled (sorted by arrival time)
+ * @param seq - Pointer to an integer vector that will contain the order that processes are scheduled in based on Process ID
+ * @param metrics - Pointer to the metrics to fill in (nullptr = none are collected)
+ */
+void simulate_policy(
+        Policy policy,
+        const PolicyOptions &options,
+        int64_t max_seq_len,
+        std::vector<Process> &processes,
+        std::vector<int> &seq,
+        Metrics *metrics
+) {
+    unique_ptr<SchedulingPolicy> decisions;
+    switch (policy) {
+        case Policy::RoundRobin:
+            decisions = make_unique<RoundRobinPolicy>(options.quantum);
+            break;
+        case Policy::Fcfs:
+            decisions = make_unique<FcfsPolicy>();
+            break;
+        case Policy::Sjf:
+        case Policy::Srtf:
+            decisions = make_unique<ShortestFirstPolicy>(policy == Policy::Srtf, processes);
+            break;
+        case Policy::Priority:
+            decisions = make_unique<PriorityPolicy>(options.aging, options.priorities);
+            break;
+        case Policy::Mlfq:
+            decisions = make_unique<MlfqPolicy>(options.quantum, options.levels, int(processes.size()));
+            break;
     }
+    simulate(*decisions, max_seq_len, processes, seq, metrics);
+}
+
+/**
+ * Function that schedules the processes on several cores, each running round robin on its own ready queue
+ * @param options - Number of cores, quantum, how processes are spread over the cores and the switch and migration costs
+ * @param max_seq_len - Number of sequences to return in the schedule of every core (cuts off anything that occurs after this number)
+ * @param processes - Pointer to a vector consisting of Process objects that will be scheduled (sorted by arrival time)
+ * @param seqs - Pointer to a vector that will contain the order that processes are scheduled in on every core
+ * @param metrics - Pointer to the metrics to fill in (nullptr = none are collected)
+ */
+void simulate_multicore(
+        const MultiCoreOptions &options,
+        int64_t max_seq_len,
+        std::vector<Process> &processes,
+        std::vector<std::vector<int>> &seqs,
+        Metrics *metrics
+) {
+    // Only collects metrics when they are asked for, the cores share one recorder
+    unique_ptr<MetricsRecorder> recorder(metrics ? new MetricsRecorder(options.cores) : nullptr);
+    MultiCoreSimulation simulation(options, max_seq_len, processes, seqs, recorder.get());
+    simulation.run();
+    if (recorder)
+        recorder->summarize(*metrics);
 }
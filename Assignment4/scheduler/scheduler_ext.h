@@ -0,0 +1,116 @@
+#pragma once
+
+#include "scheduler.h"
+#include <cstdint>
+#include <vector>
+
+// extensions of simulate_rr() that live outside of scheduler.h so the
+// assignment header stays untouched
+
+// mean and percentiles of one per-process time, the percentiles come from a
+// sketch with a relative error below 0.4% (exact below 128)
+struct Distribution {
+    double mean = 0;
+    int64_t p50 = 0;
+    int64_t p95 = 0;
+    int64_t p99 = 0;
+};
+
+// aggregate results of a simulation, filled in while it runs when a pointer
+// is passed to simulate_policy() or simulate_multicore()
+struct Metrics {
+    // number of processes that finished
+    int64_t processes = 0;
+    // finish_time - arrival_time
+    Distribution turnaround;
+    // turnaround minus burst, the time spent ready but not running
+    Distribution waiting;
+    // start_time - arrival_time
+    Distribution response;
+    // sum of the bursts over cores * (last finish - first arrival)
+    double utilization = 0;
+    // number of times a CPU was handed from one process to another
+    int64_t context_switches = 0;
+};
+
+// scheduling policies understood by simulate_policy()
+enum class Policy {
+    // round robin with a time slice of quantum, same as simulate_rr()
+    RoundRobin,
+    // first come first served
+    Fcfs,
+    // shortest job first (non-preemptive, shortest burst first)
+    Sjf,
+    // shortest remaining time first (preemptive, an arrival with a shorter
+    // burst takes the CPU away from the running process)
+    Srtf,
+    // non-preemptive priority, ready processes run in the order of
+    // priority * aging + time they became ready, so waiting counts
+    // continuously as 1 / aging of a level per time unit (no aging if aging is 0)
+    Priority,
+    // multi-level feedback queues, new processes start in the top level and a
+    // process that uses its whole slice drops one level, level i has a time
+    // slice of quantum * 2^i, an arrival preempts processes below the top level
+    Mlfq
+};
+
+struct PolicyOptions {
+    // time slice of round robin and of the top level of Mlfq, quantum > 0
+    int64_t quantum = 1;
+    // waiting time worth one priority level, aging >= 0
+    int64_t aging = 0;
+    // number of queues of Mlfq, levels > 0
+    int levels = 3;
+    // priority of every process by id (lower values run first), only used by
+    // Policy::Priority, processes without an entry have priority 0
+    std::vector<int64_t> priorities;
+};
+
+// simulates the processes under any of the policies, sets the same fields
+// and the same condensed sequence as simulate_rr(), metrics (if not nullptr)
+// is filled in while the simulation runs
+void simulate_policy(
+        Policy policy,
+        const PolicyOptions &options,
+        int64_t max_seq_len,
+        std::vector<Process> &processes,
+        std::vector<int> &seq,
+        Metrics *metrics = nullptr);
+
+// ways to spread the processes over the cores in simulate_multicore()
+enum class Balancing {
+    // a process stays on core id % cores for its whole life
+    None,
+    // a process is placed on the core with the fewest processes when it
+    // arrives and stays there
+    LeastLoaded,
+    // a process is placed on core id % cores, a core that runs out of work
+    // takes the most recently queued process of the core with the most
+    // waiting processes
+    WorkStealing
+};
+
+struct MultiCoreOptions {
+    // number of cores, cores > 0
+    int cores = 1;
+    // time slice of the round robin queue of every core, quantum > 0
+    int64_t quantum = 1;
+    Balancing balancing = Balancing::None;
+    // time a core spends before it runs a process other than the one it ran
+    // last, switch_cost >= 0
+    int64_t switch_cost = 0;
+    // extra time before a process runs on another core than the one it ran on
+    // last, migration_cost >= 0
+    int64_t migration_cost = 0;
+};
+
+// simulates the processes on several cores, every core runs its own round
+// robin queue, start_time is when a process first runs (after the switch),
+// seqs gets one condensed sequence per core (at most max_seq_len each),
+// metrics (if not nullptr) is filled in while the simulation runs
+void simulate_multicore(
+        const MultiCoreOptions &options,
+        int64_t max_seq_len,
+        std::vector<Process> &processes,
+        std::vector<std::vector<int>> &seqs,
+        Metrics *metrics = nullptr);